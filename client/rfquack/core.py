@@ -24,6 +24,7 @@ Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 import ctypes
 import inspect
+import os
 
 from google.protobuf.message import Message
 from loguru import logger
@@ -31,6 +32,17 @@ from rfquack import topics
 from rfquack.src import rfquack_pb2
 from rich import print
 
+# Capability descriptors are cached here, one per dongle.
+CAPABILITIES_CACHE_DIR = os.path.join(os.path.expanduser("~"), ".cache", "rfquack")
+
+
+def fnv1a(data):
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
 PBUF_TYPES = {
     1: ctypes.c_int32,
     2: ctypes.c_int64,
@@ -206,11 +218,14 @@ class RFQuack(object):
         self.data = list()
         self._prefix = prefix
         self.lastReply = {}
+        self.hookStats = dict()
         self._spectrum_analyzer = dict()
         self._module_names = list()
 
         self._dongles = dict()
         self._select_first_dongle = select_first_dongle
+        self._capabilities = b""
+        self._dongle_prefix = None
 
         self._init()
 
@@ -246,12 +261,85 @@ class RFQuack(object):
 
         # Listen for the new dongle prefix
         self._transport.set_prefix(dongle_prefix)
+        self._dongle_prefix = dongle_prefix
 
         # Change the incoming messages handler.
         self._transport.set_on_message_callback(self._recv)
 
-        # Ask info on the 'TOPIC_INFO', the dongle will reply back with the loaded modules
-        self._transport._send(command=topics.TOPIC_INFO, payload=b"")
+        # Ask info on the 'TOPIC_INFO', the dongle will reply back with the loaded modules.
+        # Sending the hash of the cached descriptor, if still valid the dongle won't send it again.
+        # Older firmware ignores it and describes each command in its own message.
+        self._capabilities = self._load_capabilities()
+        known = rfquack_pb2.UintValue(value=fnv1a(self._capabilities) if self._capabilities else 0)
+        self._transport._send(command=topics.TOPIC_INFO, payload=known.SerializeToString())
+
+    def _capabilities_cache_path(self):
+        return os.path.join(CAPABILITIES_CACHE_DIR, "{}.bin".format(self._dongle_prefix))
+
+    def _load_capabilities(self):
+        try:
+            with open(self._capabilities_cache_path(), "rb") as f:
+                return f.read()
+        except OSError:
+            return b""
+
+    def _save_capabilities(self, data):
+        try:
+            os.makedirs(CAPABILITIES_CACHE_DIR, exist_ok=True)
+            with open(self._capabilities_cache_path(), "wb") as f:
+                f.write(data)
+        except OSError as e:
+            logger.warning("Cannot cache capabilities: {}".format(e))
+
+    def _recv_capabilities(self, msg):
+        if msg.version != 1:
+            logger.error("Unsupported capabilities version {}".format(msg.version))
+            return
+
+        if msg.offset == msg.size and not msg.chunk:
+            # Our copy is still valid.
+            logger.info("Capabilities unchanged, using cached copy")
+            data = self._capabilities
+        else:
+            if msg.offset == 0:
+                self._capabilities = b""
+            if msg.offset != len(self._capabilities):
+                logger.error("Lost a capabilities chunk, select the dongle again")
+                return
+            self._capabilities += msg.chunk
+            if len(self._capabilities) < msg.size:
+                return
+            data = self._capabilities
+
+        if fnv1a(data) != msg.hash:
+            logger.error("Capabilities hash mismatch, select the dongle again")
+            self._save_capabilities(b"")
+            return
+        self._save_capabilities(data)
+
+        # Records: <module>\0<command>\0<argumentType>\0<description>\0<cmdType>
+        pos = 0
+        while pos < len(data):
+            fields = []
+            for _ in range(4):
+                end = data.index(b"\0", pos)
+                fields.append(data[pos:end].decode())
+                pos = end + 1
+            cmd_type = data[pos]
+            pos += 1
+            module_name, cmd_name, argument_type, description = fields
+            self._add_command(module_name, cmd_name, cmd_type, argument_type, description)
+
+    def _add_command(self, module_name, cmd_name, cmd_type, argument_type, description):
+        # Create a new attribute if missing.
+        if not hasattr(self, module_name):
+            self._module_names.append(module_name)
+            logger.info("Creating attribute q.{}".format(module_name))
+            setattr(self, module_name, ModuleInterface(self, module_name))
+
+        getattr(self, module_name)._set_autocompletion(
+            cmd_name, cmd_type, argument_type, description
+        )
 
     def _recv(self, **kwargs):
         verb = kwargs.get("verb")
@@ -263,14 +351,21 @@ class RFQuack(object):
 
         # Incoming autocompletion data
         if verb == topics.TOPIC_INFO.decode():
-            # Create a new attribute if missing.
-            if not hasattr(self, module_name):
-                self._module_names.append(module_name)
-                logger.info("Creating attribute q.{}".format(module_name))
-                setattr(self, module_name, ModuleInterface(self, module_name))
-
-            getattr(self, module_name)._set_autocompletion(
-                cmds[0], msg.cmdType, msg.argumentType, msg.description
+            if isinstance(msg, rfquack_pb2.Capabilities):
+                self._recv_capabilities(msg)
+            else:
+                self._add_command(
+                    module_name, cmds[0], msg.cmdType, msg.argumentType, msg.description
+                )
+            return
+
+        # Periodic hook timings, kept apart from replies.
+        if verb == topics.TOPIC_STATS.decode():
+            self.hookStats[(module_name, cmds[0])] = msg
+            print(
+                f"[purple]{module_name}.{cmds[0]}: {msg.calls} calls, "
+                f"min/avg/max = {msg.minUs}/{msg.avgUs}/{msg.maxUs} us, "
+                f"overruns = {msg.overruns}, histogram = {list(msg.histogram)}[/purple]"
             )
             return
 
@@ -290,6 +385,16 @@ class RFQuack(object):
             fmt = "0x{addr:02X} = 0b{value:08b} (0x{value:02X}, {value})\n"
             out += fmt.format(**dict(addr=msg.address, value=msg.value))
 
+        # Parse register dump, one register per line:
+        if isinstance(msg, rfquack_pb2.RegisterBlock):
+            fmt = "0x{addr:02X} = 0b{value:08b} (0x{value:02X}, {value})\n"
+            for i, value in enumerate(msg.values):
+                out += fmt.format(**dict(addr=msg.address + i, value=value))
+
+        # Parse register program results:
+        if isinstance(msg, rfquack_pb2.RegisterProgram):
+            out += "results = {}\n".format(list(msg.results))
+
         # Parse and store incoming packet:
         if isinstance(msg, rfquack_pb2.Packet):
             out += "hex data = {}\n".format(msg.data.hex())
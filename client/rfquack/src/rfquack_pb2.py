@@ -13,51 +13,67 @@ _sym_db = _symbol_database.Default()
 
 
 
-DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x11src/rfquack.proto\x12\x07rfquack\"8\n\tPacketLen\x12\x18\n\x10isFixedPacketLen\x18\t \x02(\x08\x12\x11\n\tpacketLen\x18\n \x02(\r\"\xed\x01\n\x0bModemConfig\x12\x13\n\x0b\x63\x61rrierFreq\x18\x01 \x01(\x02\x12\x0f\n\x07txPower\x18\x02 \x01(\x05\x12\x13\n\x0bpreambleLen\x18\x03 \x01(\r\x12\x11\n\tsyncWords\x18\x04 \x01(\x0c\x12\x15\n\risPromiscuous\x18\x05 \x01(\x08\x12\'\n\nmodulation\x18\x07 \x01(\x0e\x32\x13.rfquack.Modulation\x12\x0e\n\x06useCRC\x18\x08 \x01(\x08\x12\x0f\n\x07\x62itRate\x18\t \x01(\x02\x12\x13\n\x0brxBandwidth\x18\n \x01(\x02\x12\x1a\n\x12\x66requencyDeviation\x18\x0b \x01(\x02\"\xe2\x01\n\x06Packet\x12\x0c\n\x04\x64\x61ta\x18\x01 \x02(\x0c\x12$\n\x07rxRadio\x18\x02 \x01(\x0e\x32\x13.rfquack.WhichRadio\x12\x0e\n\x06millis\x18\x03 \x01(\x04\x12\x0e\n\x06repeat\x18\x04 \x01(\r\x12\x0f\n\x07\x62itRate\x18\x05 \x01(\x02\x12\x13\n\x0b\x63\x61rrierFreq\x18\x06 \x01(\x02\x12\x11\n\tsyncWords\x18\x07 \x01(\x0c\x12\x12\n\nmodulation\x18\x08 \x01(\t\x12\x1a\n\x12\x66requencyDeviation\x18\t \x01(\x02\x12\x0c\n\x04RSSI\x18\n \x01(\x02\x12\r\n\x05model\x18\x0b \x01(\t\"*\n\x08Register\x12\x0f\n\x07\x61\x64\x64ress\x18\x01 \x02(\r\x12\r\n\x05value\x18\x02 \x01(\r\"\x1a\n\tUintValue\x12\r\n\x05value\x18\x01 \x02(\r\"\x19\n\x08IntValue\x12\r\n\x05value\x18\x01 \x02(\x05\"\x1a\n\tBoolValue\x12\r\n\x05value\x18\x01 \x02(\x08\"\x1b\n\nFloatValue\x12\r\n\x05value\x18\x01 \x02(\x02\"\x1b\n\nBytesValue\x12\r\n\x05value\x18\x01 \x02(\x0c\"5\n\x0fWhichRadioValue\x12\"\n\x05value\x18\x01 \x02(\x0e\x32\x13.rfquack.WhichRadio\"\x0b\n\tVoidValue\"+\n\x08\x43mdReply\x12\x0e\n\x06result\x18\x01 \x02(\x05\x12\x0f\n\x07message\x18\x02 \x01(\t\"\x8d\x01\n\x07\x43mdInfo\x12\x14\n\x0c\x61rgumentType\x18\x01 \x02(\t\x12-\n\x07\x63mdType\x18\x02 \x02(\x0e\x32\x1c.rfquack.CmdInfo.CmdTypeEnum\x12\x13\n\x0b\x64\x65scription\x18\x03 \x02(\t\"(\n\x0b\x43mdTypeEnum\x12\r\n\tATTRIBUTE\x10\x01\x12\n\n\x06METHOD\x10\x02\"\x82\x02\n\x12PacketModification\x12\x10\n\x08position\x18\x01 \x01(\r\x12\x0f\n\x07\x63ontent\x18\x02 \x01(\r\x12\x31\n\toperation\x18\x03 \x01(\x0e\x32\x1e.rfquack.PacketModification.Op\x12\x0f\n\x07operand\x18\x04 \x01(\r\x12\x0f\n\x07pattern\x18\x05 \x01(\t\x12\x0f\n\x07payload\x18\x06 \x01(\x0c\"c\n\x02Op\x12\x07\n\x03\x41ND\x10\x01\x12\x06\n\x02OR\x10\x02\x12\x07\n\x03XOR\x10\x03\x12\x07\n\x03NOT\x10\x04\x12\t\n\x05SLEFT\x10\x05\x12\n\n\x06SRIGHT\x10\x06\x12\x0b\n\x07PREPEND\x10\x07\x12\n\n\x06\x41PPEND\x10\x08\x12\n\n\x06INSERT\x10\t\"3\n\x0cPacketFilter\x12\x0f\n\x07pattern\x18\x01 \x02(\t\x12\x12\n\nnegateRule\x18\x02 \x02(\x08*)\n\x04Mode\x12\x06\n\x02RX\x10\x00\x12\x06\n\x02TX\x10\x01\x12\x08\n\x04IDLE\x10\x02\x12\x07\n\x03JAM\x10\x03*H\n\nWhichRadio\x12\n\n\x06RadioA\x10\x00\x12\n\n\x06RadioB\x10\x01\x12\n\n\x06RadioC\x10\x02\x12\n\n\x06RadioD\x10\x03\x12\n\n\x06RadioE\x10\x04*H\n\nModulation\x12\x08\n\x04\x46SK2\x10\x00\x12\x08\n\x04\x46SK4\x10\x01\x12\t\n\x05GFSK2\x10\x02\x12\t\n\x05GFSK4\x10\x03\x12\x07\n\x03MSK\x10\x04\x12\x07\n\x03OOK\x10\x05')
+DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x11src/rfquack.proto\x12\x07rfquack\"L\n\x08TxReport\x12\r\n\x05jobId\x18\x01 \x02(\r\x12\x0c\n\x04sent\x18\x02 \x02(\r\x12\x0e\n\x06\x66\x61iled\x18\x03 \x02(\r\x12\x13\n\x0bjitterMaxUs\x18\x04 \x01(\r\"U\n\tPacketLen\x12\x18\n\x10isFixedPacketLen\x18\t \x02(\x08\x12\x11\n\tpacketLen\x18\n \x02(\r\x12\x1b\n\x13isInfinitePacketLen\x18\x0b \x01(\x08\"\xed\x01\n\x0bModemConfig\x12\x13\n\x0b\x63\x61rrierFreq\x18\x01 \x01(\x02\x12\x0f\n\x07txPower\x18\x02 \x01(\x05\x12\x13\n\x0bpreambleLen\x18\x03 \x01(\r\x12\x11\n\tsyncWords\x18\x04 \x01(\x0c\x12\x15\n\risPromiscuous\x18\x05 \x01(\x08\x12\'\n\nmodulation\x18\x07 \x01(\x0e\x32\x13.rfquack.Modulation\x12\x0e\n\x06useCRC\x18\x08 \x01(\x08\x12\x0f\n\x07\x62itRate\x18\t \x01(\x02\x12\x13\n\x0brxBandwidth\x18\n \x01(\x02\x12\x1a\n\x12\x66requencyDeviation\x18\x0b \x01(\x02\"\x1c\n\x0cModemProfile\x12\x0c\n\x04name\x18\x01 \x02(\t\"L\n\x0b\x43hannelPlan\x12\r\n\x05\x66reqs\x18\x01 \x03(\x02\x12\x11\n\tstartFreq\x18\x02 \x01(\x02\x12\x0c\n\x04step\x18\x03 \x01(\x02\x12\r\n\x05\x63ount\x18\x04 \x01(\r\"\xc4\x02\n\x06Packet\x12\x0c\n\x04\x64\x61ta\x18\x01 \x02(\x0c\x12$\n\x07rxRadio\x18\x02 \x01(\x0e\x32\x13.rfquack.WhichRadio\x12\x0e\n\x06millis\x18\x03 \x01(\x04\x12\x0e\n\x06repeat\x18\x04 \x01(\r\x12\x0f\n\x07\x62itRate\x18\x05 \x01(\x02\x12\x13\n\x0b\x63\x61rrierFreq\x18\x06 \x01(\x02\x12\x11\n\tsyncWords\x18\x07 \x01(\x0c\x12\x12\n\nmodulation\x18\x08 \x01(\t\x12\x1a\n\x12\x66requencyDeviation\x18\t \x01(\x02\x12\x0c\n\x04RSSI\x18\n \x01(\x02\x12\r\n\x05model\x18\x0b \x01(\t\x12\x10\n\x08rxMicros\x18\x0c \x01(\x04\x12\x16\n\x0eisrToDequeueUs\x18\r \x01(\r\x12\x0e\n\x06txAtUs\x18\x0e \x01(\x04\x12\x11\n\ttxDelayUs\x18\x0f \x01(\r\x12\x13\n\x0brepeatGapUs\x18\x10 \x01(\r\"*\n\x08Register\x12\x0f\n\x07\x61\x64\x64ress\x18\x01 \x02(\r\x12\r\n\x05value\x18\x02 \x01(\r\"@\n\rRegisterBlock\x12\x0f\n\x07\x61\x64\x64ress\x18\x01 \x02(\r\x12\x0e\n\x06length\x18\x02 \x01(\r\x12\x0e\n\x06values\x18\x03 \x01(\x0c\"G\n\x0fRegisterProgram\x12\x0f\n\x07program\x18\x01 \x02(\x0c\x12\x0f\n\x07results\x18\x02 \x01(\x0c\x12\x12\n\ndurationUs\x18\x03 \x01(\r\"\x1a\n\tUintValue\x12\r\n\x05value\x18\x01 \x02(\r\"\x19\n\x08IntValue\x12\r\n\x05value\x18\x01 \x02(\x05\"\x1a\n\tBoolValue\x12\r\n\x05value\x18\x01 \x02(\x08\"\x1b\n\nFloatValue\x12\r\n\x05value\x18\x01 \x02(\x02\"\x1b\n\nBytesValue\x12\r\n\x05value\x18\x01 \x02(\x0c\"5\n\x0fWhichRadioValue\x12\"\n\x05value\x18\x01 \x02(\x0e\x32\x13.rfquack.WhichRadio\"\x0b\n\tVoidValue\"+\n\x08\x43mdReply\x12\x0e\n\x06result\x18\x01 \x02(\x05\x12\x0f\n\x07message\x18\x02 \x01(\t\"Z\n\x0c\x43\x61pabilities\x12\x0f\n\x07version\x18\x01 \x02(\r\x12\x0c\n\x04hash\x18\x02 \x02(\r\x12\x0c\n\x04size\x18\x03 \x02(\r\x12\x0e\n\x06offset\x18\x04 \x02(\r\x12\r\n\x05\x63hunk\x18\x05 \x02(\x0c\"l\n\tHookStats\x12\r\n\x05\x63\x61lls\x18\x01 \x02(\r\x12\r\n\x05minUs\x18\x02 \x02(\r\x12\r\n\x05\x61vgUs\x18\x03 \x02(\r\x12\r\n\x05maxUs\x18\x04 \x02(\r\x12\x11\n\thistogram\x18\x05 \x03(\r\x12\x10\n\x08overruns\x18\x06 \x02(\r\"\x8d\x01\n\x07\x43mdInfo\x12\x14\n\x0c\x61rgumentType\x18\x01 \x02(\t\x12-\n\x07\x63mdType\x18\x02 \x02(\x0e\x32\x1c.rfquack.CmdInfo.CmdTypeEnum\x12\x13\n\x0b\x64\x65scription\x18\x03 \x02(\t\"(\n\x0b\x43mdTypeEnum\x12\r\n\tATTRIBUTE\x10\x01\x12\n\n\x06METHOD\x10\x02\"\x82\x02\n\x12PacketModification\x12\x10\n\x08position\x18\x01 \x01(\r\x12\x0f\n\x07\x63ontent\x18\x02 \x01(\r\x12\x31\n\toperation\x18\x03 \x01(\x0e\x32\x1e.rfquack.PacketModification.Op\x12\x0f\n\x07operand\x18\x04 \x01(\r\x12\x0f\n\x07pattern\x18\x05 \x01(\t\x12\x0f\n\x07payload\x18\x06 \x01(\x0c\"c\n\x02Op\x12\x07\n\x03\x41ND\x10\x01\x12\x06\n\x02OR\x10\x02\x12\x07\n\x03XOR\x10\x03\x12\x07\n\x03NOT\x10\x04\x12\t\n\x05SLEFT\x10\x05\x12\n\n\x06SRIGHT\x10\x06\x12\x0b\n\x07PREPEND\x10\x07\x12\n\n\x06\x41PPEND\x10\x08\x12\n\n\x06INSERT\x10\t\"3\n\x0cPacketFilter\x12\x0f\n\x07pattern\x18\x01 \x02(\t\x12\x12\n\nnegateRule\x18\x02 \x02(\x08*)\n\x04Mode\x12\x06\n\x02RX\x10\x00\x12\x06\n\x02TX\x10\x01\x12\x08\n\x04IDLE\x10\x02\x12\x07\n\x03JAM\x10\x03*H\n\nWhichRadio\x12\n\n\x06RadioA\x10\x00\x12\n\n\x06RadioB\x10\x01\x12\n\n\x06RadioC\x10\x02\x12\n\n\x06RadioD\x10\x03\x12\n\n\x06RadioE\x10\x04*H\n\nModulation\x12\x08\n\x04\x46SK2\x10\x00\x12\x08\n\x04\x46SK4\x10\x01\x12\t\n\x05GFSK2\x10\x02\x12\t\n\x05GFSK4\x10\x03\x12\x07\n\x03MSK\x10\x04\x12\x07\n\x03OOK\x10\x05*@\n\x10RxOverflowPolicy\x12\x0f\n\x0b\x44ROP_NEWEST\x10\x00\x12\x0f\n\x0b\x44ROP_OLDEST\x10\x01\x12\n\n\x06SAMPLE\x10\x02')
 
 _builder.BuildMessageAndEnumDescriptors(DESCRIPTOR, globals())
 _builder.BuildTopDescriptorsAndMessages(DESCRIPTOR, 'src.rfquack_pb2', globals())
 if _descriptor._USE_C_DESCRIPTORS == False:
 
   DESCRIPTOR._options = None
-  _MODE._serialized_start=1313
-  _MODE._serialized_end=1354
-  _WHICHRADIO._serialized_start=1356
-  _WHICHRADIO._serialized_end=1428
-  _MODULATION._serialized_start=1430
-  _MODULATION._serialized_end=1502
-  _PACKETLEN._serialized_start=30
-  _PACKETLEN._serialized_end=86
-  _MODEMCONFIG._serialized_start=89
-  _MODEMCONFIG._serialized_end=326
-  _PACKET._serialized_start=329
-  _PACKET._serialized_end=555
-  _REGISTER._serialized_start=557
-  _REGISTER._serialized_end=599
-  _UINTVALUE._serialized_start=601
-  _UINTVALUE._serialized_end=627
-  _INTVALUE._serialized_start=629
-  _INTVALUE._serialized_end=654
-  _BOOLVALUE._serialized_start=656
-  _BOOLVALUE._serialized_end=682
-  _FLOATVALUE._serialized_start=684
-  _FLOATVALUE._serialized_end=711
-  _BYTESVALUE._serialized_start=713
-  _BYTESVALUE._serialized_end=740
-  _WHICHRADIOVALUE._serialized_start=742
-  _WHICHRADIOVALUE._serialized_end=795
-  _VOIDVALUE._serialized_start=797
-  _VOIDVALUE._serialized_end=808
-  _CMDREPLY._serialized_start=810
-  _CMDREPLY._serialized_end=853
-  _CMDINFO._serialized_start=856
-  _CMDINFO._serialized_end=997
-  _CMDINFO_CMDTYPEENUM._serialized_start=957
-  _CMDINFO_CMDTYPEENUM._serialized_end=997
-  _PACKETMODIFICATION._serialized_start=1000
-  _PACKETMODIFICATION._serialized_end=1258
-  _PACKETMODIFICATION_OP._serialized_start=1159
-  _PACKETMODIFICATION_OP._serialized_end=1258
-  _PACKETFILTER._serialized_start=1260
-  _PACKETFILTER._serialized_end=1311
+  _MODE._serialized_start=1967
+  _MODE._serialized_end=2008
+  _WHICHRADIO._serialized_start=2010
+  _WHICHRADIO._serialized_end=2082
+  _MODULATION._serialized_start=2084
+  _MODULATION._serialized_end=2156
+  _RXOVERFLOWPOLICY._serialized_start=2158
+  _RXOVERFLOWPOLICY._serialized_end=2222
+  _TXREPORT._serialized_start=30
+  _TXREPORT._serialized_end=106
+  _PACKETLEN._serialized_start=108
+  _PACKETLEN._serialized_end=193
+  _MODEMCONFIG._serialized_start=196
+  _MODEMCONFIG._serialized_end=433
+  _MODEMPROFILE._serialized_start=435
+  _MODEMPROFILE._serialized_end=463
+  _CHANNELPLAN._serialized_start=465
+  _CHANNELPLAN._serialized_end=541
+  _PACKET._serialized_start=544
+  _PACKET._serialized_end=868
+  _REGISTER._serialized_start=870
+  _REGISTER._serialized_end=912
+  _REGISTERBLOCK._serialized_start=914
+  _REGISTERBLOCK._serialized_end=978
+  _REGISTERPROGRAM._serialized_start=980
+  _REGISTERPROGRAM._serialized_end=1051
+  _UINTVALUE._serialized_start=1053
+  _UINTVALUE._serialized_end=1079
+  _INTVALUE._serialized_start=1081
+  _INTVALUE._serialized_end=1106
+  _BOOLVALUE._serialized_start=1108
+  _BOOLVALUE._serialized_end=1134
+  _FLOATVALUE._serialized_start=1136
+  _FLOATVALUE._serialized_end=1163
+  _BYTESVALUE._serialized_start=1165
+  _BYTESVALUE._serialized_end=1192
+  _WHICHRADIOVALUE._serialized_start=1194
+  _WHICHRADIOVALUE._serialized_end=1247
+  _VOIDVALUE._serialized_start=1249
+  _VOIDVALUE._serialized_end=1260
+  _CMDREPLY._serialized_start=1262
+  _CMDREPLY._serialized_end=1305
+  _CAPABILITIES._serialized_start=1307
+  _CAPABILITIES._serialized_end=1397
+  _HOOKSTATS._serialized_start=1399
+  _HOOKSTATS._serialized_end=1507
+  _CMDINFO._serialized_start=1510
+  _CMDINFO._serialized_end=1651
+  _CMDINFO_CMDTYPEENUM._serialized_start=1611
+  _CMDINFO_CMDTYPEENUM._serialized_end=1651
+  _PACKETMODIFICATION._serialized_start=1654
+  _PACKETMODIFICATION._serialized_end=1912
+  _PACKETMODIFICATION_OP._serialized_start=1813
+  _PACKETMODIFICATION_OP._serialized_end=1912
+  _PACKETFILTER._serialized_start=1914
+  _PACKETFILTER._serialized_end=1965
 # @@protoc_insertion_point(module_scope)
@@ -38,3 +38,4 @@ TOPIC_OUT = b"out"
 TOPIC_GET = b"get"
 TOPIC_SET = b"set"
 TOPIC_INFO = b"info"
+TOPIC_STATS = b"stats"
@@ -43,6 +43,10 @@
 #define RFQUACK_STATS_LOOP_PERIOD_MS RFQUACK_STATS_LOOP_PERIOD_MS_DEFAULT
 #endif
 
+#ifndef RFQUACK_LOOP_IDLE_SLEEP_MAX_MS
+#define RFQUACK_LOOP_IDLE_SLEEP_MAX_MS RFQUACK_LOOP_IDLE_SLEEP_MAX_MS_DEFAULT
+#endif
+
 #ifndef RFQUACK_MAX_PACKET_MODIFICATIONS
 #define RFQUACK_MAX_PACKET_MODIFICATIONS RFQUACK_MAX_PACKET_MODIFICATIONS_DEFAULT
 #endif
@@ -29,6 +29,7 @@
 #define RFQUACK_CONN_WAIT_MS_DEFAULT 1000
 #define RFQUACK_RX_TIMEOUT_MS_DEFAULT 1000
 #define RFQUACK_STATS_LOOP_PERIOD_MS_DEFAULT 20000L
+#define RFQUACK_LOOP_IDLE_SLEEP_MAX_MS_DEFAULT 10
 #define RFQUACK_MAX_PACKET_MODIFICATIONS_DEFAULT 64
 #define RFQUACK_MAX_PACKET_FILTERS_DEFAULT 64
 #define RFQUACK_MAX_MODULES_DEFAULT 20
@@ -22,8 +22,60 @@
 #ifndef rfquack_defaults_radio_h
 #define rfquack_defaults_radio_h
 
+// Packets each radio's RX queue can hold.
 #define RFQUACK_RADIO_RX_QUEUE_LEN_DEFAULT 128
 
+// RX queue draining: packets popped per loop iteration, grown up to MAX_BATCH
+// while the queue sits above HIGH_WATERMARK, reset once below LOW_WATERMARK.
+#define RFQUACK_RADIO_RX_DRAIN_BATCH_DEFAULT 4
+#define RFQUACK_RADIO_RX_DRAIN_MAX_BATCH_DEFAULT 32
+#define RFQUACK_RADIO_RX_DRAIN_HIGH_WATERMARK_DEFAULT (RFQUACK_RADIO_RX_QUEUE_LEN / 4)
+#define RFQUACK_RADIO_RX_DRAIN_LOW_WATERMARK_DEFAULT (RFQUACK_RADIO_RX_QUEUE_LEN / 16)
+#define RFQUACK_RADIO_RX_DRAIN_BUDGET_US_DEFAULT 2000
+
+// Packets drained from a radio's RX queue per round-robin turn.
+#define RFQUACK_RADIO_RX_WEIGHT_DEFAULT 1
+
+// TX jobs queued per radio, and how long a frame may wait for the channel or for its completion IRQ.
+#define RFQUACK_RADIO_TX_QUEUE_LEN_DEFAULT 8
+#define RFQUACK_RADIO_TX_TIMEOUT_US_DEFAULT 60000
+
+// A scheduled frame due within this time is waited for in the TX loop rather than left to the next loop (us).
+#define RFQUACK_RADIO_TX_SPIN_US_DEFAULT 1000
+
+// What to do when the RX queue is full (rfquack_RxOverflowPolicy), and N for the SAMPLE policy.
+#define RFQUACK_RADIO_RX_OVERFLOW_POLICY_DEFAULT rfquack_RxOverflowPolicy_DROP_NEWEST
+#define RFQUACK_RADIO_RX_OVERFLOW_SAMPLE_EVERY_DEFAULT 8
+
+// Packet slots: enough to fill one RX queue, plus packets being received or held by modules.
+// Shared by all radios, it bounds the packets queued overall: each radio in use keeps
+// RESERVED_PER_RADIO of them for itself, so a full queue can't starve the other radios.
+// Every slot (an rfquack_Packet) takes about 400 bytes of RAM.
+#define RFQUACK_PACKET_POOL_SIZE_DEFAULT (RFQUACK_RADIO_RX_QUEUE_LEN + 16)
+#define RFQUACK_PACKET_POOL_RESERVED_PER_RADIO_DEFAULT 8
+
+// RX tasks (RFQUACK_RADIO_RX_TASKS): one task per radio, woken by the radio interrupt.
+// The poll period is a fallback for IRQ lines that stay asserted between packets.
+#define RFQUACK_RADIO_RX_TASK_CORE_DEFAULT CONFIG_ARDUINO_RUNNING_CORE
+#define RFQUACK_RADIO_RX_TASK_PRIORITY_DEFAULT 5
+#define RFQUACK_RADIO_RX_TASK_STACK_DEFAULT 4096
+#define RFQUACK_RADIO_RX_TASK_POLL_MS_DEFAULT 10
+#define RFQUACK_RADIO_RX_TASK_BURST_DEFAULT 8
+
+// Pipeline (RFQUACK_RADIO_PIPELINE): a single radio task, on the core not running the main loop.
+// Priority, stack and poll period are shared with RX tasks.
+#define RFQUACK_RADIO_PIPELINE_CORE_DEFAULT (CONFIG_ARDUINO_RUNNING_CORE == 0 ? 1 : 0)
+
+// NVS namespaces holding modem profiles, and the profile each radio loads at boot.
+#define RFQUACK_PROFILE_NVS_NAMESPACE_DEFAULT "rfq_profiles"
+#define RFQUACK_PROFILE_BOOT_NVS_NAMESPACE_DEFAULT "rfq_boot"
+
+// Max run time of a register program (us), it blocks the main loop.
+#define RFQUACK_REGISTER_PROGRAM_MAX_US_DEFAULT 500000
+
+// Max channels in a radio's channel plan (12 bytes each).
+#define RFQUACK_MAX_CHANNELS_DEFAULT 256
+
 #ifndef RFQUACK_REGISTER_HEX_FORMAT
 #define RFQUACK_REGISTER_HEX_FORMAT "%x"
 #endif
@@ -36,5 +88,106 @@
 #define RFQUACK_RADIO_RX_QUEUE_LEN RFQUACK_RADIO_RX_QUEUE_LEN_DEFAULT
 #endif
 
+#ifndef RFQUACK_PACKET_POOL_SIZE
+#define RFQUACK_PACKET_POOL_SIZE RFQUACK_PACKET_POOL_SIZE_DEFAULT
+#endif
+
+#ifndef RFQUACK_PACKET_POOL_RESERVED_PER_RADIO
+#define RFQUACK_PACKET_POOL_RESERVED_PER_RADIO RFQUACK_PACKET_POOL_RESERVED_PER_RADIO_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_RX_DRAIN_BATCH
+#define RFQUACK_RADIO_RX_DRAIN_BATCH RFQUACK_RADIO_RX_DRAIN_BATCH_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_RX_DRAIN_MAX_BATCH
+#define RFQUACK_RADIO_RX_DRAIN_MAX_BATCH RFQUACK_RADIO_RX_DRAIN_MAX_BATCH_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_RX_DRAIN_HIGH_WATERMARK
+#define RFQUACK_RADIO_RX_DRAIN_HIGH_WATERMARK RFQUACK_RADIO_RX_DRAIN_HIGH_WATERMARK_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_RX_DRAIN_LOW_WATERMARK
+#define RFQUACK_RADIO_RX_DRAIN_LOW_WATERMARK RFQUACK_RADIO_RX_DRAIN_LOW_WATERMARK_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_RX_DRAIN_BUDGET_US
+#define RFQUACK_RADIO_RX_DRAIN_BUDGET_US RFQUACK_RADIO_RX_DRAIN_BUDGET_US_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_RX_WEIGHT
+#define RFQUACK_RADIO_RX_WEIGHT RFQUACK_RADIO_RX_WEIGHT_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_TX_QUEUE_LEN
+#define RFQUACK_RADIO_TX_QUEUE_LEN RFQUACK_RADIO_TX_QUEUE_LEN_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_TX_TIMEOUT_US
+#define RFQUACK_RADIO_TX_TIMEOUT_US RFQUACK_RADIO_TX_TIMEOUT_US_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_TX_SPIN_US
+#define RFQUACK_RADIO_TX_SPIN_US RFQUACK_RADIO_TX_SPIN_US_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_RX_OVERFLOW_POLICY
+#define RFQUACK_RADIO_RX_OVERFLOW_POLICY RFQUACK_RADIO_RX_OVERFLOW_POLICY_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_RX_OVERFLOW_SAMPLE_EVERY
+#define RFQUACK_RADIO_RX_OVERFLOW_SAMPLE_EVERY RFQUACK_RADIO_RX_OVERFLOW_SAMPLE_EVERY_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_RX_TASK_CORE
+#define RFQUACK_RADIO_RX_TASK_CORE RFQUACK_RADIO_RX_TASK_CORE_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_RX_TASK_PRIORITY
+#define RFQUACK_RADIO_RX_TASK_PRIORITY RFQUACK_RADIO_RX_TASK_PRIORITY_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_RX_TASK_STACK
+#define RFQUACK_RADIO_RX_TASK_STACK RFQUACK_RADIO_RX_TASK_STACK_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_RX_TASK_POLL_MS
+#define RFQUACK_RADIO_RX_TASK_POLL_MS RFQUACK_RADIO_RX_TASK_POLL_MS_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_RX_TASK_BURST
+#define RFQUACK_RADIO_RX_TASK_BURST RFQUACK_RADIO_RX_TASK_BURST_DEFAULT
+#endif
+
+#ifndef RFQUACK_RADIO_PIPELINE_CORE
+#define RFQUACK_RADIO_PIPELINE_CORE RFQUACK_RADIO_PIPELINE_CORE_DEFAULT
+#endif
+
+#ifndef RFQUACK_PROFILE_NVS_NAMESPACE
+#define RFQUACK_PROFILE_NVS_NAMESPACE RFQUACK_PROFILE_NVS_NAMESPACE_DEFAULT
+#endif
+
+#ifndef RFQUACK_PROFILE_BOOT_NVS_NAMESPACE
+#define RFQUACK_PROFILE_BOOT_NVS_NAMESPACE RFQUACK_PROFILE_BOOT_NVS_NAMESPACE_DEFAULT
+#endif
+
+#ifndef RFQUACK_REGISTER_PROGRAM_MAX_US
+#define RFQUACK_REGISTER_PROGRAM_MAX_US RFQUACK_REGISTER_PROGRAM_MAX_US_DEFAULT
+#endif
+
+#ifndef RFQUACK_MAX_CHANNELS
+#define RFQUACK_MAX_CHANNELS RFQUACK_MAX_CHANNELS_DEFAULT
+#endif
+
+#if defined(RFQUACK_RADIO_RX_TASKS) && defined(RFQUACK_RADIO_PIPELINE)
+#error "RFQUACK_RADIO_RX_TASKS and RFQUACK_RADIO_PIPELINE are mutually exclusive."
+#endif
+
+// Radios are read outside of the main loop.
+#if defined(RFQUACK_RADIO_RX_TASKS) || defined(RFQUACK_RADIO_PIPELINE)
+#define RFQUACK_RADIO_THREADED
+#endif
+
 
 #endif
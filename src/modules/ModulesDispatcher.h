@@ -2,9 +2,12 @@
 #define RFQUACK_PROJECT_MODULESDISPATCHER_H
 
 
+#include <type_traits>
+#include <utility>
 #include "../rfquack_common.h"
 #include "../rfquack_logging.h"
 #include "RFQModule.h"
+#include "RFQHookStats.h"
 #include "modules/hooks/OnPacketReceived.h"
 #include "modules/hooks/AfterPacketReceived.h"
 #include "modules/hooks/OnLoop.h"
@@ -21,19 +24,86 @@ public:
       RFQUACK_LOG_TRACE(F("Got command for moduleName: %s, verb: %s, argsLen: %d, messageLen %d"),
                         moduleName, verb, argsLen, messageLen);
 
+      // Hash the command once, modules look it up in their routing table.
+      RFQCommandKey command;
+      command.verb = rfquack_hash(verb);
+      command.arg0 = argsLen > 0 && args[0] != NULL ? rfquack_hash(args[0]) : 0;
+      command.arg1 = argsLen > 1 && args[1] != NULL ? rfquack_hash(args[1]) : 0;
+
       // INFO verb is sent to ask information about current RFQuack supported modules and commands.
-      bool isInfo = strncmp(verb, RFQUACK_TOPIC_INFO, strlen(RFQUACK_TOPIC_INFO)) == 0;
+      bool isInfo = command.verb == RFQUACK_HASH(RFQUACK_TOPIC_INFO) && strcmp(verb, RFQUACK_TOPIC_INFO) == 0;
 
-      // Redirect the received command to the right module(s).
-      for (int i = 0; i < loadedModules; i++) {
-        RFQModule *module = this->modules[i];
-        if (isInfo || strcmp(moduleName, module->getName()) == 0) {
-          module->executeUserCommand(verb, args, argsLen, messagePayload, messageLen);
-          if (!isInfo) return;
+      // Clients sending the hash of the descriptor they know get the whole descriptor, unless it's unchanged.
+      // Without it, every command is described in its own message.
+      if (isInfo && messageLen > 0) {
+        rfquack_UintValue knownHash = rfquack_UintValue_init_default;
+        PB_DECODE(knownHash, rfquack_UintValue_fields, messagePayload, messageLen);
+        sendCapabilities(knownHash.value);
+        return;
+      }
+
+      // Every module describes its commands.
+      if (isInfo) {
+        for (int i = 0; i < loadedModules; i++) {
+          this->modules[i]->handleUserCommand(command, verb, args, argsLen, messagePayload, messageLen);
         }
+        return;
       }
 
-      if (!isInfo) RFQUACK_LOG_ERROR(F("Module '%s' not found."), moduleName);
+      // Redirect the received command to the right module.
+      RFQModule *module = moduleName != NULL ? findModule(moduleName) : nullptr;
+      if (module == nullptr) {
+        RFQUACK_LOG_ERROR(F("Module '%s' not found."), moduleName);
+        return;
+      }
+      module->handleUserCommand(command, verb, args, argsLen, messagePayload, messageLen);
+
+      // The command may have enabled the module or changed its state, look at every onLoop() hook again.
+      nextDueMs = millis();
+    }
+
+    /**
+     * Builds the descriptor of every registered module's commands, served by sendCapabilities().
+     */
+    void buildCapabilities() {
+      capabilities.clear();
+      for (int i = 0; i < loadedModules; i++) {
+        this->modules[i]->describeCommands(capabilities);
+      }
+      capabilities.finish();
+      RFQUACK_LOG_TRACE(F("Capabilities: %d bytes, hash %x"), capabilities.getSize(), capabilities.getHash())
+    }
+
+    /**
+     * Sends the capability descriptor in chunks, or just its header if the client already has it.
+     *
+     * @param knownHash hash of the descriptor cached by the client (0 if none).
+     */
+    void sendCapabilities(uint32_t knownHash) {
+      if (capabilities.isEmpty()) buildCapabilities();
+
+      rfquack_Capabilities pkt = rfquack_Capabilities_init_default;
+      pkt.version = RFQCapabilities::VERSION;
+      pkt.hash = capabilities.getHash();
+      pkt.size = capabilities.getSize();
+
+      if (knownHash == capabilities.getHash()) {
+        // No chunk: the client's copy is up to date.
+        pkt.offset = pkt.size;
+        PB_ENCODE_AND_SEND(rfquack_Capabilities, pkt, RFQUACK_TOPIC_INFO, "rfquack", "capabilities")
+        return;
+      }
+
+      size_t offset = 0;
+      do {
+        size_t len = capabilities.getSize() - offset;
+        if (len > sizeof(pkt.chunk.bytes)) len = sizeof(pkt.chunk.bytes);
+        pkt.offset = offset;
+        pkt.chunk.size = len;
+        memcpy(pkt.chunk.bytes, capabilities.getData() + offset, len);
+        PB_ENCODE_AND_SEND(rfquack_Capabilities, pkt, RFQUACK_TOPIC_INFO, "rfquack", "capabilities")
+        offset += len;
+      } while (offset < capabilities.getSize());
     }
 
     /**
@@ -45,19 +115,19 @@ public:
      * @return whatever to push packet in RX Queue.
      */
     bool onPacketReceived(rfquack_Packet &packet, rfquack_WhichRadio whichRadio) {
-      for (int i = 0; i < loadedModules; i++) {
-        RFQModule *module = this->modules[i];
+      for (int i = 0; i < onPacketReceivedHooks.count; i++) {
+        Hook<OnPacketReceived> &hook = onPacketReceivedHooks.hooks[i];
+        if (!hook.module->isEnabled()) continue;
 
         // Notify all modules until a module breaks the chain returning false.
         // Example: A 'filter module' returns false as soon as a packet is not passing the sieve,
         //          the packet will be instantly discharged.
         // Note: Changes to 'packet' will persist across modules.
-        if (module->isEnabled()) {
-          if (OnPacketReceived *mdl = dynamic_cast<OnPacketReceived *>(module)) {
-            if (!mdl->onPacketReceived(packet, whichRadio)) {
-              return false; // Return false, 'module' stopped the chain.
-            }
-          }
+        uint32_t start = ESP.getCycleCount();
+        bool pass = hook.handler->onPacketReceived(packet, whichRadio);
+        hook.stats.record(ESP.getCycleCount() - start, cyclesPerUs);
+        if (!pass) {
+          return false; // Return false, 'module' stopped the chain.
         }
       }
 
@@ -72,15 +142,15 @@ public:
      * @return whatever to send packet to client.
      */
     bool afterPacketReceived(rfquack_Packet &packet, rfquack_WhichRadio whichRadio) {
-      for (int i = 0; i < loadedModules; i++) {
-        RFQModule *module = this->modules[i];
+      for (int i = 0; i < afterPacketReceivedHooks.count; i++) {
+        Hook<AfterPacketReceived> &hook = afterPacketReceivedHooks.hooks[i];
+        if (!hook.module->isEnabled()) continue;
 
-        if (module->isEnabled()) {
-          if (AfterPacketReceived *mdl = dynamic_cast<AfterPacketReceived *>(module)) {
-            if (!mdl->afterPacketReceived(packet, whichRadio)) {
-              return false; // Return false, 'module' stopped the chain.
-            }
-          }
+        uint32_t start = ESP.getCycleCount();
+        bool pass = hook.handler->afterPacketReceived(packet, whichRadio);
+        hook.stats.record(ESP.getCycleCount() - start, cyclesPerUs);
+        if (!pass) {
+          return false; // Return false, 'module' stopped the chain.
         }
       }
 
@@ -91,20 +161,76 @@ public:
     /**
      * Called on each main loop to allow any registered and enabled module to
      * perform its business logic.
+     *
+     * Hooks are called when due according to their RFQLoopSchedule, highest priority first.
+     * Nothing is looked at until the earliest due time.
      */
     void onLoop() {
-      for (int i = 0; i < loadedModules; i++) {
-        RFQModule *module = this->modules[i];
+      uint32_t now = millis();
+
+      if ((int32_t) (now - nextDueMs) >= 0) {
+        // With no hook enabled, check again after the longest idle sleep.
+        nextDueMs = now + RFQUACK_LOOP_IDLE_SLEEP_MAX_MS;
+
+        for (int i = 0; i < onLoopHooks.count; i++) {
+          LoopHook &hook = onLoopHooks.hooks[i];
+          if (!hook.module->isEnabled()) continue;
 
-        if (module->isEnabled()) {
-          if (OnLoop *mdl = dynamic_cast<OnLoop *>(module)) {
-            mdl->onLoop();
+          if ((int32_t) (now - hook.dueMs) >= 0) {
+            runLoopHook(hook);
           }
+          if ((int32_t) (hook.dueMs - nextDueMs) < 0) nextDueMs = hook.dueMs;
         }
       }
+
+#if RFQUACK_STATS_LOOP_PERIOD_MS > 0
+      if (millis() - lastStatsMs >= RFQUACK_STATS_LOOP_PERIOD_MS) {
+        lastStatsMs = millis();
+        publishStats();
+      }
+#endif
+    }
+
+    /**
+     * @return milliseconds until an onLoop() hook is due, 0 if one is due now.
+     */
+    uint32_t getIdleMs() {
+      int32_t idle = (int32_t) (nextDueMs - millis());
+      return idle > 0 ? (uint32_t) idle : 0;
     }
 
-    void registerModule(RFQModule *module) {
+    /**
+     * Sends the hook timings gathered since the last call on the stats topic, one
+     * rfquack_HookStats per module and hook (hooks that didn't run are skipped), then starts over.
+     */
+    void publishStats() {
+      for (int i = 0; i < onPacketReceivedHooks.count; i++) {
+        Hook<OnPacketReceived> &hook = onPacketReceivedHooks.hooks[i];
+        rfquack_HookStats pkt = rfquack_HookStats_init_default;
+        if (!takeStats(hook.stats, pkt)) continue;
+        PB_ENCODE_AND_SEND(rfquack_HookStats, pkt, RFQUACK_TOPIC_STATS, hook.module->getName(), "on_packet_received")
+      }
+      for (int i = 0; i < afterPacketReceivedHooks.count; i++) {
+        Hook<AfterPacketReceived> &hook = afterPacketReceivedHooks.hooks[i];
+        rfquack_HookStats pkt = rfquack_HookStats_init_default;
+        if (!takeStats(hook.stats, pkt)) continue;
+        PB_ENCODE_AND_SEND(rfquack_HookStats, pkt, RFQUACK_TOPIC_STATS, hook.module->getName(), "after_packet_received")
+      }
+      for (int i = 0; i < onLoopHooks.count; i++) {
+        LoopHook &hook = onLoopHooks.hooks[i];
+        rfquack_HookStats pkt = rfquack_HookStats_init_default;
+        if (!takeStats(hook.stats, pkt)) continue;
+        PB_ENCODE_AND_SEND(rfquack_HookStats, pkt, RFQUACK_TOPIC_STATS, hook.module->getName(), "on_loop")
+      }
+    }
+
+    /**
+     * Registers a module, adding it to the lists of the hooks it implements.
+     * Hooks are found from the module's type at compile time: pass the module with its own type, not as RFQModule.
+     */
+    template<typename M>
+    void registerModule(M *module) {
+      static_assert(std::is_base_of<RFQModule, M>::value, "Modules must extend RFQModule");
       RFQUACK_LOG_TRACE(F("Registering modules..."));
 
       if (loadedModules >= RFQUACK_MAX_MODULES) {
@@ -114,18 +240,159 @@ public:
 
       // Initialize module
       module->onInit();
+      module->buildRoutes();
+
+      // CPU frequency is settled by now, hook timings are converted with it.
+      cyclesPerUs = ESP.getCpuFreqMHz();
 
       // Save reference to module in order to be able to query it.
       this->modules[loadedModules] = module;
 
       // Increment the number of loaded modules.
       loadedModules++;
+
+      // Keep modules sorted by name hash too, for findModule().
+      int i = loadedModules - 1;
+      for (; i > 0 && modulesByName[i - 1]->getNameHash() > module->getNameHash(); i--) {
+        modulesByName[i] = modulesByName[i - 1];
+      }
+      modulesByName[i] = module;
+
+      // Described again on next request.
+      capabilities.clear();
+
+      // Hooks are called in registration order.
+      addHook<OnPacketReceived>(onPacketReceivedHooks, module, std::is_base_of<OnPacketReceived, M>());
+      addHook<AfterPacketReceived>(afterPacketReceivedHooks, module, std::is_base_of<AfterPacketReceived, M>());
+      addHook<OnLoop>(onLoopHooks, module, std::is_base_of<OnLoop, M>());
       RFQUACK_LOG_TRACE(F("Module '%s' registered."), module->getName())
     }
 
 private:
+    // A module implementing hook H, with the pointer to call it through (cast once, at registration).
+    template<typename H>
+    struct Hook {
+        RFQModule *module;
+        H *handler;
+        RFQHookStats stats;
+    };
+
+    // An onLoop() hook with its schedule.
+    struct LoopHook : Hook<OnLoop> {
+        RFQLoopSchedule schedule;
+        uint32_t dueMs;
+    };
+
+    template<typename H, typename E = Hook<H>>
+    struct HookList {
+        E hooks[RFQUACK_MAX_MODULES];
+        int count = 0;
+    };
+
+    template<typename H, typename E, typename M>
+    void addHook(HookList<H, E> &list, M *module, std::true_type) {
+      E &hook = list.hooks[list.count];
+      hook.module = module;
+      hook.handler = static_cast<H *>(module);
+      hook.stats.reset();
+      scheduleHook(list, list.count);
+      list.count++;
+    }
+
+    template<typename H, typename E, typename M>
+    void addHook(HookList<H, E> &list, M *module, std::false_type) {
+      // Module doesn't implement the hook.
+    }
+
+    template<typename H, typename E>
+    void scheduleHook(HookList<H, E> &list, int i) {
+      // Only onLoop() hooks have a schedule.
+    }
+
+    // Reads the module's schedule, keeping the list sorted by priority (registration order among equals).
+    void scheduleHook(HookList<OnLoop, LoopHook> &list, int i) {
+      list.hooks[i].schedule = list.hooks[i].handler->getLoopSchedule();
+      list.hooks[i].dueMs = millis();
+      while (i > 0 && list.hooks[i - 1].schedule.priority < list.hooks[i].schedule.priority) {
+        std::swap(list.hooks[i - 1], list.hooks[i]);
+        i--;
+      }
+      nextDueMs = millis();
+    }
+
+    // Calls a due hook and computes its next due time.
+    void runLoopHook(LoopHook &hook) {
+      // Hooks before this one may have taken a while.
+      uint32_t now = millis();
+      uint32_t start = ESP.getCycleCount();
+      hook.handler->onLoop();
+      uint32_t cycles = ESP.getCycleCount() - start;
+      hook.stats.record(cycles, cyclesPerUs);
+
+      uint32_t lateUs = (now - hook.dueMs) * 1000 + cycles / cyclesPerUs;
+      if (hook.schedule.deadlineUs > 0 && lateUs > hook.schedule.deadlineUs) {
+        hook.stats.overruns++;
+        RFQUACK_LOG_TRACE(F("Module '%s' missed its onLoop() deadline by %u us"), hook.module->getName(),
+                          lateUs - hook.schedule.deadlineUs)
+      }
+
+      // Keep the period, unless calls were missed: then start over from now.
+      hook.dueMs += hook.schedule.periodMs;
+      if ((int32_t) (hook.dueMs - now) <= 0) hook.dueMs = now + hook.schedule.periodMs;
+
+      if (hook.handler->_postponeMs > 0) {
+        uint32_t postponed = now + hook.handler->_postponeMs;
+        if ((int32_t) (postponed - hook.dueMs) > 0) hook.dueMs = postponed;
+        hook.handler->_postponeMs = 0;
+      }
+    }
+
+    // Converts the stats of a hook, resetting them. Returns false if the hook didn't run.
+    bool takeStats(RFQHookStats &stats, rfquack_HookStats &pkt) {
+      if (stats.calls == 0) return false;
+      pkt.calls = stats.calls;
+      pkt.minUs = stats.minCycles / cyclesPerUs;
+      pkt.avgUs = (uint32_t) (stats.totalCycles / stats.calls / cyclesPerUs);
+      pkt.maxUs = stats.maxCycles / cyclesPerUs;
+      pkt.overruns = stats.overruns;
+      pkt.histogram_count = RFQHookStats::BUCKETS;
+      memcpy(pkt.histogram, stats.histogram, sizeof(stats.histogram));
+      stats.reset();
+      return true;
+    }
+
+    // Binary search of a module by the hash of its name.
+    RFQModule *findModule(const char *moduleName) {
+      uint32_t nameHash = rfquack_hash(moduleName);
+      int lo = 0, hi = loadedModules;
+      while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (modulesByName[mid]->getNameHash() < nameHash) lo = mid + 1;
+        else hi = mid;
+      }
+      for (; lo < loadedModules && modulesByName[lo]->getNameHash() == nameHash; lo++) {
+        if (strcmp(moduleName, modulesByName[lo]->getName()) == 0) return modulesByName[lo];
+      }
+      return nullptr;
+    }
+
     RFQModule *modules[RFQUACK_MAX_MODULES];
+    RFQModule *modulesByName[RFQUACK_MAX_MODULES];
     int loadedModules = 0;
+
+    // Hook timings, see publishStats().
+    uint32_t cyclesPerUs = 240;
+    uint32_t lastStatsMs = 0;
+
+    HookList<OnPacketReceived> onPacketReceivedHooks;
+    HookList<AfterPacketReceived> afterPacketReceivedHooks;
+    HookList<OnLoop, LoopHook> onLoopHooks;
+
+    // Earliest due time among the enabled onLoop() hooks.
+    uint32_t nextDueMs = 0;
+
+    // Commands of every module, see buildCapabilities().
+    RFQCapabilities capabilities;
 };
 
 // Global ModulesDispatcher instance.
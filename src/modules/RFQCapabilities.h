@@ -0,0 +1,94 @@
+#ifndef RFQUACK_PROJECT_RFQCAPABILITIES_H
+#define RFQUACK_PROJECT_RFQCAPABILITIES_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Descriptor of the commands of every module, built once and served to clients in a few chunks
+ * (see ModulesDispatcher::sendCapabilities()) instead of one rfquack_CmdInfo message per command.
+ *
+ * It's a list of records, one per command:
+ *   <module>\0<command>\0<argumentType>\0<description>\0<cmdType byte>
+ * Its FNV-1a hash lets clients cache it and skip discovery while the firmware doesn't change.
+ * Bump VERSION whenever the record layout changes.
+ */
+class RFQCapabilities {
+public:
+    static const uint8_t VERSION = 1;
+
+    ~RFQCapabilities() {
+      clear();
+    }
+
+    void clear() {
+      free(_data);
+      _data = nullptr;
+      _size = 0;
+      _capacity = 0;
+      _hash = 0;
+    }
+
+    bool add(const char *module, const char *command, const char *argumentType, const char *description,
+             uint8_t cmdType) {
+      size_t needed = strlen(module) + strlen(command) + strlen(argumentType) + strlen(description) + 5;
+      if (!reserve(_size + needed)) return false;
+      append(module);
+      append(command);
+      append(argumentType);
+      append(description);
+      _data[_size++] = cmdType;
+      return true;
+    }
+
+    // Computes the hash, once every command is in.
+    void finish() {
+      uint32_t hash = 2166136261u;
+      for (size_t i = 0; i < _size; i++) {
+        hash = (hash ^ _data[i]) * 16777619u;
+      }
+      _hash = hash;
+    }
+
+    bool isEmpty() const {
+      return _size == 0;
+    }
+
+    const uint8_t *getData() const {
+      return _data;
+    }
+
+    size_t getSize() const {
+      return _size;
+    }
+
+    uint32_t getHash() const {
+      return _hash;
+    }
+
+private:
+    bool reserve(size_t size) {
+      if (size <= _capacity) return true;
+      size_t capacity = _capacity == 0 ? 1024 : _capacity;
+      while (capacity < size) capacity *= 2;
+      auto *data = (uint8_t *) realloc(_data, capacity);
+      if (data == nullptr) return false;
+      _data = data;
+      _capacity = capacity;
+      return true;
+    }
+
+    void append(const char *str) {
+      size_t len = strlen(str) + 1;
+      memcpy(_data + _size, str, len);
+      _size += len;
+    }
+
+    uint8_t *_data = nullptr;
+    size_t _size = 0;
+    size_t _capacity = 0;
+    uint32_t _hash = 0;
+};
+
+#endif //RFQUACK_PROJECT_RFQCAPABILITIES_H
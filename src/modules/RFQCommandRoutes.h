@@ -0,0 +1,142 @@
+#ifndef RFQUACK_PROJECT_RFQCOMMANDROUTES_H
+#define RFQUACK_PROJECT_RFQCOMMANDROUTES_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <type_traits>
+
+/**
+ * Routing table of a module's commands: the handler of each CMD_MATCHES_* macro, keyed by the hashes
+ * of verb and command name, sorted once so that a command is found by binary search.
+ *
+ * Handlers are the lambdas built by the macros, capturing only the module: they're stored in place,
+ * with a thunk calling them. Strings are compared only to confirm a match.
+ */
+class RFQCommandRoutes {
+public:
+    typedef void (*Thunk)(const void *handler, char *verb, char **args, uint8_t argsLen,
+                          char *messagePayload, unsigned int messageLen);
+
+    ~RFQCommandRoutes() {
+      clear();
+    }
+
+    void clear() {
+      free(_routes);
+      _routes = nullptr;
+      _count = 0;
+      _capacity = 0;
+    }
+
+    /**
+     * Adds the handler of a command.
+     *
+     * @param verb verb the command answers to (RFQUACK_TOPIC_SET, RFQUACK_TOPIC_GET).
+     * @param type protobuf type preceding the name in the topic, nullptr if the name comes first.
+     * @param name command name.
+     */
+    template<typename L>
+    bool add(const char *verb, uint32_t verbHash, const char *type, const char *name, uint32_t nameHash,
+             const L &handler) {
+      static_assert(sizeof(L) <= sizeof(void *) && std::is_trivially_copyable<L>::value,
+                    "Command handlers may only capture the module");
+      if (!reserve(_count + 1)) return false;
+
+      Route &route = _routes[_count++];
+      route.key = makeKey(verbHash, nameHash, type != nullptr);
+      route.verb = verb;
+      route.type = type;
+      route.name = name;
+      memcpy(&route.handler, &handler, sizeof(L));
+      route.thunk = &invoke<L>;
+      return true;
+    }
+
+    // Sorts the routes, once every command is in.
+    void finish() {
+      for (uint16_t i = 1; i < _count; i++) {
+        Route route = _routes[i];
+        uint16_t j = i;
+        for (; j > 0 && _routes[j - 1].key > route.key; j--) _routes[j] = _routes[j - 1];
+        _routes[j] = route;
+      }
+    }
+
+    /**
+     * Runs the handler of a command, found from its hashes: name after the type first (set commands),
+     * then name first (get commands).
+     *
+     * @return false if no route matches.
+     */
+    bool dispatch(uint32_t verbHash, uint32_t arg0Hash, uint32_t arg1Hash, char *verb, char **args,
+                  uint8_t argsLen, char *messagePayload, unsigned int messageLen) {
+      const Route *route = nullptr;
+      if (argsLen > 1) route = find(makeKey(verbHash, arg1Hash, true), verb, args, argsLen);
+      if (route == nullptr && argsLen > 0) route = find(makeKey(verbHash, arg0Hash, false), verb, args, argsLen);
+      if (route == nullptr) return false;
+
+      route->thunk(&route->handler, verb, args, argsLen, messagePayload, messageLen);
+      return true;
+    }
+
+    uint16_t getCount() const {
+      return _count;
+    }
+
+private:
+    struct Route {
+        uint32_t key;
+        const char *verb;
+        const char *type;
+        const char *name;
+        void *handler; // Storage of the handler, not a pointer to it.
+        Thunk thunk;
+    };
+
+    static uint32_t makeKey(uint32_t verbHash, uint32_t nameHash, bool typed) {
+      return (verbHash * 16777619u) ^ nameHash ^ (typed ? 0x80000000u : 0);
+    }
+
+    template<typename L>
+    static void invoke(const void *handler, char *verb, char **args, uint8_t argsLen,
+                       char *messagePayload, unsigned int messageLen) {
+      (*static_cast<const L *>(handler))(verb, args, argsLen, messagePayload, messageLen);
+    }
+
+    const Route *find(uint32_t key, const char *verb, char **args, uint8_t argsLen) const {
+      // First route with this key.
+      uint16_t lo = 0, hi = _count;
+      while (lo < hi) {
+        uint16_t mid = (lo + hi) / 2;
+        if (_routes[mid].key < key) lo = mid + 1;
+        else hi = mid;
+      }
+
+      for (; lo < _count && _routes[lo].key == key; lo++) {
+        const Route &route = _routes[lo];
+        const char *type = route.type != nullptr && argsLen > 1 ? args[0] : nullptr;
+        const char *name = route.type != nullptr ? (argsLen > 1 ? args[1] : nullptr) : args[0];
+        if (strcmp(verb, route.verb) != 0 || name == nullptr || strcmp(name, route.name) != 0) continue;
+        if (route.type != nullptr && (type == nullptr || strcmp(type, route.type) != 0)) continue;
+        return &route;
+      }
+      return nullptr;
+    }
+
+    bool reserve(uint16_t count) {
+      if (count <= _capacity) return true;
+      uint16_t capacity = _capacity == 0 ? 8 : _capacity * 2;
+      auto *routes = (Route *) realloc(_routes, capacity * sizeof(Route));
+      if (routes == nullptr) return false;
+      _routes = routes;
+      _capacity = capacity;
+      return true;
+    }
+
+    Route *_routes = nullptr;
+    uint16_t _count = 0;
+    uint16_t _capacity = 0;
+};
+
+#endif //RFQUACK_PROJECT_RFQCOMMANDROUTES_H
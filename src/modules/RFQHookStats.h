@@ -0,0 +1,51 @@
+#ifndef RFQUACK_PROJECT_RFQHOOKSTATS_H
+#define RFQUACK_PROJECT_RFQHOOKSTATS_H
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Execution time of a module's hook (see ModulesDispatcher), measured in CPU cycles and
+ * reported in microseconds: min/avg/max plus a log-scale histogram. Scheduled onLoop() hooks
+ * also count the calls that missed their deadline (see RFQLoopSchedule).
+ *
+ * Histogram buckets grow by 4x: < 1us, < 4us, < 16us, ..., the last one counts the rest.
+ * Updated without locks: with RX tasks a sample may rarely be lost, good enough for a profiler.
+ */
+class RFQHookStats {
+public:
+    static const uint8_t BUCKETS = 8;
+
+    void record(uint32_t cycles, uint32_t cyclesPerUs) {
+      if (calls == 0 || cycles < minCycles) minCycles = cycles;
+      if (cycles > maxCycles) maxCycles = cycles;
+      totalCycles += cycles;
+      calls++;
+
+      uint32_t us = cycles / cyclesPerUs;
+      uint8_t bucket = 0;
+      while (us > 0 && bucket < BUCKETS - 1) {
+        us >>= 2;
+        bucket++;
+      }
+      histogram[bucket]++;
+    }
+
+    void reset() {
+      calls = 0;
+      minCycles = 0;
+      maxCycles = 0;
+      totalCycles = 0;
+      overruns = 0;
+      memset(histogram, 0, sizeof(histogram));
+    }
+
+    uint32_t calls = 0;
+    uint32_t minCycles = 0;
+    uint32_t maxCycles = 0;
+    uint64_t totalCycles = 0;
+    uint32_t overruns = 0;
+    uint32_t histogram[BUCKETS] = {0};
+};
+
+#endif //RFQUACK_PROJECT_RFQHOOKSTATS_H
@@ -1,7 +1,26 @@
 #ifndef RFQUACK_PROJECT_RFQMODULE_H
 #define RFQUACK_PROJECT_RFQMODULE_H
 
+#include <type_traits>
 #include "../rfquack_common.h"
+#include "RFQCapabilities.h"
+#include "RFQCommandRoutes.h"
+
+// 32 bit FNV-1a hash of a command identifier (module name, verb, argument type, command name).
+constexpr uint32_t rfquack_hash(const char *str, uint32_t hash = 2166136261u) {
+  return *str == '\0' ? hash : rfquack_hash(str + 1, (hash ^ (uint8_t) *str) * 16777619u);
+}
+
+// Hash of a string literal, computed at compile time.
+#define RFQUACK_HASH(literal) (std::integral_constant<uint32_t, rfquack_hash(literal)>::value)
+
+// Hashes of an incoming command, computed once by ModulesDispatcher: commands are looked up in the
+// module's routing table by hash, strings are compared only to confirm a match.
+struct RFQCommandKey {
+    uint32_t verb = 0;
+    uint32_t arg0 = 0;  // 0 if missing.
+    uint32_t arg1 = 0;
+};
 
 // Decodes a protobuf payload
 #define PB_DECODE(pkt, fields, payload, payload_length) { \
@@ -12,38 +31,44 @@
   } \
 }
 
+// Adds a command handler to the routing table, while it's being built (see RFQModule::buildRoutes()).
+// The handler is the code block, run with the arguments of executeUserCommand().
+#define _CMD_ROUTE(verbValue, typeValue, cmdValue, ...) { \
+  if (_routes != nullptr) { \
+    _routes->add(verbValue, RFQUACK_HASH(verbValue), typeValue, cmdValue, RFQUACK_HASH(cmdValue), \
+                 [this](char *verb, char **args, uint8_t argsLen, char *messagePayload, unsigned int messageLen) \
+                 __VA_ARGS__); \
+  } \
+}
+
 // rfquack/in/set/<moduleName>/<protobuf_type>/<cmdValue>
 // Example: rfquack/in/set/driver/rfquack_FloatValue/frequency
-#define _CMD_MATCHES_SET(pbStruct, cmdValue, command) { \
-  if (strcmp(verb, RFQUACK_TOPIC_SET) == 0 && (args[0] != NULL && strcmp(args[0], #pbStruct) == 0) \
-      && (args[1] != NULL && strcmp(args[1], cmdValue) == 0) ) { \
+#define _CMD_MATCHES_SET(pbStruct, cmdValue, ...) \
+  _CMD_ROUTE(RFQUACK_TOPIC_SET, #pbStruct, cmdValue, { \
     pbStruct pkt =  pbStruct ## _init_default ; \
     PB_DECODE(pkt, pbStruct ## _fields, messagePayload, messageLen); \
     rfquack_CmdReply reply = rfquack_CmdReply_init_default; \
-    command; \
+    __VA_ARGS__; \
     PB_ENCODE_AND_SEND(rfquack_CmdReply, reply, RFQUACK_TOPIC_SET, this->name, cmdValue) \
-    return; \
-  } \
-}
+  })
 
 // rfquack/in/get/<moduleName>/<cmdValue>
 // Example: rfquack/in/get/driver/frequency
-#define _CMD_MATCHES_GET(cmdValue, command) { \
-  if (strcmp(verb, RFQUACK_TOPIC_GET) == 0 && (args[0] != NULL && strcmp(args[0], cmdValue) == 0)) { \
-      command; \
-      return; \
-  } \
-}
+#define _CMD_MATCHES_GET(cmdValue, ...) _CMD_ROUTE(RFQUACK_TOPIC_GET, nullptr, cmdValue, { __VA_ARGS__; })
 
 // Replies to rfquack/in/info with command info.
 #define _DESCRIPTION(cmdValue, cmdDescription, pbStruct, _cmdType) { \
-  if (strcmp(verb, RFQUACK_TOPIC_INFO) == 0){ \
-    rfquack_CmdInfo pkt = rfquack_CmdInfo_init_default; \
-    strcpy_P(pkt.argumentType, (PGM_P) F(#pbStruct));\
-    strcpy_P(pkt.description, (PGM_P) F(cmdDescription)); \
-    pkt.cmdType = _cmdType; \
-    RFQUACK_LOG_TRACE(F("Sending " #cmdValue " info to client")); \
-    PB_ENCODE_AND_SEND(rfquack_CmdInfo, pkt, RFQUACK_TOPIC_INFO, this->name, cmdValue)  \
+  if (_command.verb == RFQUACK_HASH(RFQUACK_TOPIC_INFO) && strcmp(verb, RFQUACK_TOPIC_INFO) == 0){ \
+    if (_capabilities != nullptr) { \
+      _capabilities->add(this->name, cmdValue, #pbStruct, cmdDescription, _cmdType); \
+    } else { \
+      rfquack_CmdInfo pkt = rfquack_CmdInfo_init_default; \
+      strcpy_P(pkt.argumentType, (PGM_P) F(#pbStruct));\
+      strcpy_P(pkt.description, (PGM_P) F(cmdDescription)); \
+      pkt.cmdType = _cmdType; \
+      RFQUACK_LOG_TRACE(F("Sending " #cmdValue " info to client")); \
+      PB_ENCODE_AND_SEND(rfquack_CmdInfo, pkt, RFQUACK_TOPIC_INFO, this->name, cmdValue)  \
+    } \
   } \
 }
 
@@ -64,6 +89,39 @@
   _DESCRIPTION(cmdValue, cmdDescription, pbStruct, rfquack_CmdInfo_CmdTypeEnum_ATTRIBUTE) \
 }
 
+// Same as _CMD_MATCHES_PRIMITIVE_PB, a SET is undone if isValid (evaluated after the change) is false.
+#define _CMD_MATCHES_PRIMITIVE_PB_CHECKED(pbStruct, cmdValue, targetVariable, isValid, cmdDescription) { \
+  _CMD_MATCHES_SET(pbStruct, cmdValue, { \
+    auto previous = targetVariable; \
+    targetVariable = pkt.value; \
+    if (!(isValid)) { \
+      targetVariable = previous; \
+      setReplyMessage(reply, F("Value " cmdValue " rejected, inconsistent."), -1); \
+    } \
+  }) \
+  _CMD_MATCHES_GET(cmdValue, { \
+    pbStruct pkt = pbStruct ## _init_default ; \
+    pkt.value = targetVariable; \
+    RFQUACK_LOG_TRACE(F("Sending " #cmdValue " value to client")); \
+    PB_ENCODE_AND_SEND(pbStruct, pkt, RFQUACK_TOPIC_GET, this->name, cmdValue) \
+  })  \
+  _DESCRIPTION(cmdValue, cmdDescription, pbStruct, rfquack_CmdInfo_CmdTypeEnum_ATTRIBUTE) \
+}
+
+// Replies to GET requests, refuses SET ones (e.g. for counters and stats).
+#define _CMD_MATCHES_PRIMITIVE_PB_READONLY(pbStruct, cmdValue, sourceVariable, cmdDescription) { \
+  _CMD_MATCHES_SET(pbStruct, cmdValue, { \
+    setReplyMessage(reply, F("Attribute " cmdValue " is read-only."), -1); \
+  }) \
+  _CMD_MATCHES_GET(cmdValue, { \
+    pbStruct pkt = pbStruct ## _init_default ; \
+    pkt.value = sourceVariable; \
+    RFQUACK_LOG_TRACE(F("Sending " #cmdValue " value to client")); \
+    PB_ENCODE_AND_SEND(pbStruct, pkt, RFQUACK_TOPIC_GET, this->name, cmdValue) \
+  })  \
+  _DESCRIPTION(cmdValue, cmdDescription, pbStruct, rfquack_CmdInfo_CmdTypeEnum_ATTRIBUTE) \
+}
+
 #define CMD_MATCHES_BOOL(cmdValue, description, targetVariable) { \
   _CMD_MATCHES_PRIMITIVE_PB(rfquack_BoolValue, cmdValue, targetVariable, description) \
 }
@@ -89,13 +147,27 @@
   _CMD_MATCHES_PRIMITIVE_PB(rfquack_WhichRadioValue, cmdValue, targetVariable, description) \
 }
 
-#define CMD_MATCHES_METHOD_CALL(pbStruct, cmdValue, description, command) _CMD_MATCHES_SET(pbStruct, cmdValue, command) _DESCRIPTION(cmdValue, description, pbStruct, rfquack_CmdInfo_CmdTypeEnum_METHOD)
+// Like CMD_MATCHES_UINT, refusing values for which isValid is false (e.g. bounds given by other settings).
+#define CMD_MATCHES_UINT_CHECKED(cmdValue, description, targetVariable, isValid) { \
+  _CMD_MATCHES_PRIMITIVE_PB_CHECKED(rfquack_UintValue, cmdValue, targetVariable, isValid, description) \
+}
+
+#define CMD_MATCHES_UINT_READONLY(cmdValue, description, sourceVariable) { \
+  _CMD_MATCHES_PRIMITIVE_PB_READONLY(rfquack_UintValue, cmdValue, sourceVariable, description) \
+}
+
+#define CMD_MATCHES_FLOAT_READONLY(cmdValue, description, sourceVariable) { \
+  _CMD_MATCHES_PRIMITIVE_PB_READONLY(rfquack_FloatValue, cmdValue, sourceVariable, description) \
+}
+
+#define CMD_MATCHES_METHOD_CALL(pbStruct, cmdValue, description, ...) _CMD_MATCHES_SET(pbStruct, cmdValue, __VA_ARGS__) _DESCRIPTION(cmdValue, description, pbStruct, rfquack_CmdInfo_CmdTypeEnum_METHOD)
 
 class RFQModule {
 public:
     RFQModule(const char *moduleName) {
       this->name = new char[strlen(moduleName) + 1];
       strcpy(this->name, moduleName);
+      this->nameHash = rfquack_hash(moduleName);
     }
 
 public:
@@ -107,14 +179,17 @@ public:
 
 
     /**
-     * Called when user sends a command to configure this module.
-     * Use predefined macros to match an incoming command:
+     * Declares the commands of this module, with the predefined macros below.
+     * It's run once when the module is registered, to fill its routing table with the code of each macro,
+     * then on info requests. Matching commands run that code straight from the table.
      *
      *      CMD_MATCHES_BOOL(cmdValue, description, target_bool_Variable)
      *      CMD_MATCHES_UINT(cmdValue, description, target_uint8_t_Variable)
      *      CMD_MATCHES_FLOAT(cmdValue, description, target_float_Variable)
      *      CMD_MATCHES_BYTES(cmdValue, description, target_**_Variable) **
      *      CMD_MATCHES_WHICHRADIO(cmdValue, description, target_rfquack_Whichradio_Variable)
+     *      CMD_MATCHES_UINT_READONLY(cmdValue, description, source_uint_Variable)
+     *      CMD_MATCHES_FLOAT_READONLY(cmdValue, description, source_float_Variable)
      *          Params:
      *              cmdValue: How the variable will be called on CLI.
      *              description: Textual description that will be sent to CLI.
@@ -161,14 +236,64 @@ public:
       CMD_MATCHES_BOOL("enabled", "Enable or disable this module.", enabled)
     }
 
+    /**
+     * Called by ModulesDispatcher: runs the handler of the command from the routing table.
+     * Commands without a route (info requests, commands not matched by the macros) go through
+     * executeUserCommand().
+     */
+    void handleUserCommand(const RFQCommandKey &command, char *verb, char **args, uint8_t argsLen,
+                           char *messagePayload, unsigned int messageLen) {
+      if (_routeTable.dispatch(command.verb, command.arg0, command.arg1, verb, args, argsLen, messagePayload,
+                               messageLen)) {
+        return;
+      }
+      _command = command;
+      executeUserCommand(verb, args, argsLen, messagePayload, messageLen);
+    }
+
+    /**
+     * Called by ModulesDispatcher when the module is registered: runs executeUserCommand() once to
+     * collect the handler of every CMD_MATCHES_* macro.
+     */
+    void buildRoutes() {
+      char verb[] = "";
+      char *args[] = {nullptr, nullptr};
+      _command = RFQCommandKey();
+      _routeTable.clear();
+      _routes = &_routeTable;
+      executeUserCommand(verb, args, 0, nullptr, 0);
+      _routes = nullptr;
+      _routeTable.finish();
+    }
+
+    /**
+     * Called by ModulesDispatcher: adds the commands of this module to a capability descriptor.
+     */
+    void describeCommands(RFQCapabilities &capabilities) {
+      char verb[] = RFQUACK_TOPIC_INFO;
+      char *args[] = {nullptr, nullptr};
+      _command = RFQCommandKey();
+      _command.verb = RFQUACK_HASH(RFQUACK_TOPIC_INFO);
+      _capabilities = &capabilities;
+      executeUserCommand(verb, args, 0, nullptr, 0);
+      _capabilities = nullptr;
+    }
+
     char *getName() { return this->name; }
 
+    uint32_t getNameHash() const { return this->nameHash; }
+
     bool isEnabled() const {
       return enabled;
     }
 
 protected:
     char *name; // Name of the module.
+    uint32_t nameHash; // rfquack_hash() of the name.
+    RFQCommandKey _command; // Hashes of the command being executed.
+    RFQCapabilities *_capabilities = nullptr; // Set while describing commands (see describeCommands()).
+    RFQCommandRoutes _routeTable; // Handlers of the commands, see buildRoutes().
+    RFQCommandRoutes *_routes = nullptr; // Set while building the routing table.
     bool enabled = false; // Whatever the module is enabled when loaded.
 
     void setReplyMessage(rfquack_CmdReply &reply, const __FlashStringHelper *message) {
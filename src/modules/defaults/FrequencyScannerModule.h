@@ -88,6 +88,10 @@ public:
         return;
       }
 
+      // Hand the radio back as it was once done (not all radios support it).
+      RFQRadioSnapshot previousState;
+      rfqRadio->takeSnapshot(previousState, radioToUse);
+
       rfqRadio->setPromiscuousMode(false, radioToUse);
 
       // Apply best known configurations.
@@ -121,6 +125,14 @@ public:
       uint16_t hops = (endFrequency - startFrequency) / frequencyStep;
       RFQUACK_LOG_TRACE(F("We'll change frequency %d times"), hops)
 
+      // Compile every frequency once, so that each hop only writes precomputed registers.
+      if (int16_t result = rfqRadio->setChannelRange(startFrequency, frequencyStep, hops, radioToUse)) {
+        this->enabled = false;
+        rfqRadio->restoreSnapshot(previousState, radioToUse);
+        setReplyMessage(reply, F("Unable to compile the frequency range"), result);
+        return;
+      }
+
       // array to store results
       Item *results{new Item[hops]{}};
       memset(results, 0, sizeof(Item) * hops);
@@ -133,7 +145,7 @@ public:
         for (int hop = 0; hop < hops; hop++) {
 
           // Try to set frequency
-          if (int16_t result = rfqRadio->setFrequency(startFrequency, radioToUse) != RADIOLIB_ERR_NONE) {
+          if (int16_t result = rfqRadio->hopToChannel(hop, radioToUse)) {
             Log.error(F("Unable to setFrequency = %d Hz, result=%d"), (int) (currentFreq * 1000), result);
           } else {
 
@@ -159,6 +171,7 @@ public:
 
       // Disable module
       this->enabled = false;
+      rfqRadio->restoreSnapshot(previousState, radioToUse);
 
       // Sort the array of results
       bubbleSort(results, hops);
@@ -76,22 +76,27 @@ public:
         return;
       }
 
+      // Save registers before modifying them.
+      if (!previousState.taken) {
+        if (int16_t result = rfqRadio->takeSnapshot(previousState, scanRadio)) {
+          setReplyMessage(reply, F("Unable to save radio state"), result);
+          return;
+        }
+      }
+
       // Check if start and stop frequencies are allowed.
       if (int16_t result = rfqRadio->setFrequency(startFrequency, scanRadio) != RADIOLIB_ERR_NONE) {
+        rfqRadio->restoreSnapshot(previousState, scanRadio);
         setReplyMessage(reply, F("startFrequency is not valid"), result);
         return;
       }
       if (int16_t result =
         rfqRadio->setFrequency(endFrequency, scanRadio) != RADIOLIB_ERR_NONE || endFrequency <= startFrequency) {
+        rfqRadio->restoreSnapshot(previousState, scanRadio);
         setReplyMessage(reply, F("endFrequency is not valid"), result);
         return;
       }
 
-      // Save registers before modifying them.
-      if (previousRegisters == nullptr) {
-        saveRegisters();
-      }
-
       // Disable autocal
       rfqRadio->writeRegister(RADIOLIB_CC1101_REG_MCSM0, RADIOLIB_CC1101_FS_AUTOCAL_NEVER, 5, 4, scanRadio);
 
@@ -110,8 +115,8 @@ public:
       this->enabled = false;
 
       // Restore registers
-      if (previousRegisters != nullptr) {
-        restoreRegisters();
+      if (previousState.taken) {
+        rfqRadio->restoreSnapshot(previousState, scanRadio);
       }
 
       setReplyMessage(reply, F("Stopped."));
@@ -201,7 +206,10 @@ public:
 
     void onLoop() override {
       // Skip if a packet was received in last 100ms... there's no need to change freq :)
-      if (millis() - lastRxActivity < 100) {
+      // Wake up when the 100ms are over instead of checking again on each loop.
+      ulong quietFor = millis() - lastRxActivity;
+      if (quietFor < 100) {
+        postponeLoop(100 - quietFor);
         return;
       }
 
@@ -381,44 +389,8 @@ private:
       return rssi;
     }
 
-    void saveRegisters() {
-      if (previousRegisters != nullptr) {
-        RFQUACK_LOG_ERROR(F("previousRegisters is not null"));
-        return;
-      }
-
-      uint8_t registersToStore[] = {RADIOLIB_CC1101_REG_MDMCFG2, RADIOLIB_CC1101_REG_MCSM0, RADIOLIB_CC1101_REG_AGCCTRL2, RADIOLIB_CC1101_REG_FSCTRL1,
-                                    RADIOLIB_CC1101_REG_FREND1,
-                                    RADIOLIB_CC1101_FSCAL0, RADIOLIB_CC1101_REG_TEST0, RADIOLIB_CC1101_REG_TEST1, RADIOLIB_CC1101_REG_TEST2};
-
-      // Store a copy of the registers since we'll alter them.
-      previousRegisters = new rfquack_Register[sizeof(registersToStore)];
-      previousRegistersSize = sizeof(registersToStore);
-
-      for (int i = 0; i < previousRegistersSize; i++) {
-        previousRegisters[i].address = registersToStore[i];
-        previousRegisters[i].value = rfqRadio->readRegister(registersToStore[i], scanRadio);
-      }
-    }
-
-    void restoreRegisters() {
-      if (previousRegisters == nullptr) {
-        RFQUACK_LOG_ERROR(F("previousRegisters null"));
-        return;
-      }
-
-      // Put registers back.
-      for (int i = 0; i < previousRegistersSize; i++) {
-        rfqRadio->writeRegister(previousRegisters[i].address, previousRegisters[i].value, scanRadio);
-
-      }
-      delete[] previousRegisters;
-      previousRegisters = nullptr;
-    }
-
-    // Store previous value of altered registers.
-    rfquack_Register *previousRegisters = nullptr;
-    uint8_t previousRegistersSize = 0;
+    // Radio state before the scan, put back when stopping.
+    RFQRadioSnapshot previousState;
 
     void calibrate() {
       // Delete any previous calibration.
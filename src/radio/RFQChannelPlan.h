@@ -0,0 +1,58 @@
+#ifndef RFQUACK_PROJECT_RFQCHANNELPLAN_H
+#define RFQUACK_PROJECT_RFQCHANNELPLAN_H
+
+#include <stdint.h>
+#include <new>
+#include "../defaults/radio.h"
+
+/**
+ * A channel compiled by a driver: the registers to write to tune on it (frequency words and,
+ * where the chip needs it, the calibration results), so that hopping recomputes nothing.
+ */
+struct RFQChannel {
+    static const uint8_t IMAGE_SIZE = 6;
+
+    float freq;
+    uint8_t length;   // Registers in the image, 0 if the driver has no image (hops with setFrequency()).
+    uint8_t image[IMAGE_SIZE];
+};
+
+/**
+ * Channels a radio hops on, by index (see RadioLibWrapper::setChannelPlan()).
+ */
+class RFQChannelPlan {
+public:
+    ~RFQChannelPlan() {
+      clear();
+    }
+
+    // Allocates room for count channels (up to RFQUACK_MAX_CHANNELS), dropping the previous ones.
+    bool resize(uint16_t count) {
+      clear();
+      if (count == 0 || count > RFQUACK_MAX_CHANNELS) return false;
+      _channels = new(std::nothrow) RFQChannel[count];
+      if (_channels == nullptr) return false;
+      _count = count;
+      return true;
+    }
+
+    void clear() {
+      delete[] _channels;
+      _channels = nullptr;
+      _count = 0;
+    }
+
+    uint16_t getCount() const {
+      return _count;
+    }
+
+    RFQChannel &operator[](uint16_t i) {
+      return _channels[i];
+    }
+
+private:
+    RFQChannel *_channels = nullptr;
+    uint16_t _count = 0;
+};
+
+#endif //RFQUACK_PROJECT_RFQCHANNELPLAN_H
@@ -6,12 +6,11 @@
 
 class RFQMock {
 public:
-    RFQMock() {
-      _rxQueue = new Queue(sizeof(rfquack_Packet), RFQUACK_RADIO_RX_QUEUE_LEN, FIFO, true);
-    }
+    RFQMock() {}
 
     void setWhichRadio(rfquack_WhichRadio whichRadio) {
       _whichRadio = whichRadio;
+      packetPool.reserve(whichRadio);
     }
 
     int16_t begin() {
@@ -30,6 +29,10 @@ public:
       return RADIOLIB_ERR_NONE;
     }
 
+    int16_t rearmReceive() {
+      return receiveMode();
+    }
+
     int16_t transmitMode() {
       _mode = rfquack_Mode_TX;
       RFQUACK_LOG_TRACE("Tx mode entered");
@@ -58,8 +61,20 @@ public:
       return RADIOLIB_ERR_NONE;
     }
 
-    int16_t transmit(rfquack_Packet *pkt) {
-      return transmit(pkt->data.bytes, pkt->data.size);
+    int16_t transmit(rfquack_Packet *pkt, uint32_t *jobId = nullptr) {
+      return _txQueue.enqueue(pkt, jobId);
+    }
+
+    int16_t stageTransmit(uint8_t *data, size_t len) {
+      return RADIOLIB_ERR_NONE;
+    }
+
+    int16_t fireStaged() {
+      return RADIOLIB_ERR_NONE;
+    }
+
+    bool popTxReport(rfquack_TxReport *report) {
+      return _txQueue.popReport(report);
     }
 
     int16_t readData(uint8_t *data, size_t len) {
@@ -68,12 +83,43 @@ public:
 
     unsigned long lastRX = 0;
 
-    void rxLoop() {
+    void txLoop() {
+      // Every frame goes through.
+      RFQTxJob *job = _txQueue.front();
+      if (job == nullptr) return;
+      job->sent += job->remaining;
+      job->remaining = 0;
+      _txQueue.complete();
+    }
+
+    bool isTxChannelFree() {
+      return true;
+    }
+
+    bool isIdle() {
+      return _txQueue.front() == nullptr && _mode != rfquack_Mode_RX;
+    }
+
+    bool isIncomingDataAvailable() {
+      return false;
+    }
+
+    bool isReceivingPacket() {
+      return false;
+    }
+
+    void rxLoop(RFQPacketRing *rxQueue) {
       // Check if there's pending data on radio's RX FIFO.
       if (_mode == rfquack_Mode_RX && (millis() - lastRX) > 5000) {
         lastRX = millis();
 
-        rfquack_Packet pkt = rfquack_Packet_init_default;
+        _stats.received++;
+        rfquack_packet_handle_t handle = packetPool.acquire(_whichRadio);
+        if (handle == RFQUACK_PACKET_HANDLE_NONE) {
+          _stats.dropped++;
+          return;
+        }
+        rfquack_Packet &pkt = *packetPool.get(handle);
 
         char str[] = "HELLO WORLD";
         int len = strlen(str); // Text without null terminator
@@ -82,12 +128,20 @@ public:
         RFQUACK_LOG_TRACE("Received (fake) packet of len %d !", len)
 
         // Put radio back in receiveMode.
-        receiveMode();
+        rearmReceive();
+
+        pkt.rxRadio = _whichRadio;
+        pkt.has_rxRadio = true;
+        pkt.rxMicros = esp_timer_get_time();
+        pkt.has_rxMicros = true;
 
         // Filter packet
         if (modulesDispatcher.onPacketReceived(pkt, _whichRadio)) {
           // If packet passed filtering put it in rxQueue.
-          enqueuePacket(&pkt);
+          enqueuePacket(handle, rxQueue);
+        } else {
+          _stats.filtered++;
+          packetPool.release(handle);
         }
       }
     }
@@ -97,7 +151,23 @@ public:
       return out;
     }
 
-    void writeRegister(rfquack_register_address_t reg, rfquack_register_value_t value) {
+    void writeRegister(rfquack_register_address_t reg, rfquack_register_value_t value, uint8_t msb = 7,
+                       uint8_t lsb = 0) {
+    }
+
+    int16_t readRegisterBlock(uint8_t first, uint8_t len, uint8_t *values) {
+      memset(values, 57, len);
+      return RADIOLIB_ERR_NONE;
+    }
+
+    int16_t writeRegisterBlock(uint8_t first, uint8_t len, const uint8_t *values) {
+      return RADIOLIB_ERR_NONE;
+    }
+
+    void flushRegisters() {
+    }
+
+    void invalidateRegisterCache() {
     }
 
     int16_t setPreambleLength(uint32_t size) {
@@ -124,19 +194,113 @@ public:
       return RADIOLIB_ERR_NONE;
     }
 
+    int16_t infinitePacketLengthMode(uint8_t captureLen) {
+      return RADIOLIB_ERR_NONE;
+    }
+
     int16_t setPromiscuousMode(bool isPromiscuous) {
       return RADIOLIB_ERR_NONE;
     }
 
+    int16_t setAutoAck(bool autoAckOn) {
+      return ERR_COMMAND_NOT_IMPLEMENTED;
+    }
+
+    char *getChipName() const {
+      return (char *) "Mock";
+    }
+
+    void invalidateModemShadow() {
+    }
+
+    void syncModemShadow() {
+    }
 
-    Queue *getRxQueue() const {
-      return _rxQueue;
+    RFQRadioStats *getStats() {
+      return &_stats;
+    }
+
+    RFQRxOverflow *getRxOverflow() {
+      return &_rxOverflow;
+    }
+
+#ifdef RFQUACK_RADIO_THREADED
+    void lock() {
+    }
+
+    void unlock() {
+    }
+#endif
+
+#ifdef RFQUACK_RADIO_PIPELINE
+    // No interrupt: the mock is polled by the radio task.
+    void setRxNotifyTask(TaskHandle_t task) {
+    }
+#endif
+
+#ifdef RFQUACK_RADIO_RX_TASKS
+
+    // No interrupt to wake a task up: the mock is polled by the main loop.
+    void startRxTask(RFQPacketRing *rxQueue) {
+    }
+
+    bool hasRxTask() {
+      return false;
+    }
+#endif
+
+    int16_t getRSSI(float *rssi) {
+      return ERR_COMMAND_NOT_IMPLEMENTED;
+    }
+
+    int16_t isCarrierDetected(bool *isDetected) {
+      return ERR_COMMAND_NOT_IMPLEMENTED;
     }
 
     int16_t setCrcFiltering(bool isPromiscuous) {
       return true;
     }
 
+    int16_t applyModemConfig(rfquack_ModemConfig &cfg) {
+      return ERR_COMMAND_NOT_IMPLEMENTED;
+    }
+
+    int16_t saveProfile(RFQModemProfile &profile) {
+      return ERR_COMMAND_NOT_IMPLEMENTED;
+    }
+
+    int16_t loadProfile(const RFQModemProfile &profile) {
+      return ERR_COMMAND_NOT_IMPLEMENTED;
+    }
+
+    int16_t takeSnapshot(RFQRadioSnapshot &snapshot) {
+      return ERR_COMMAND_NOT_IMPLEMENTED;
+    }
+
+    int16_t restoreSnapshot(RFQRadioSnapshot &snapshot) {
+      return ERR_COMMAND_NOT_IMPLEMENTED;
+    }
+
+    int16_t setChannelPlan(const float *freqs, uint16_t count) {
+      return ERR_COMMAND_NOT_IMPLEMENTED;
+    }
+
+    int16_t setChannelRange(float startFreq, float step, uint16_t count) {
+      return ERR_COMMAND_NOT_IMPLEMENTED;
+    }
+
+    int16_t hopToChannel(uint16_t index) {
+      return ERR_NO_SUCH_CHANNEL;
+    }
+
+    uint16_t getChannelCount() {
+      return 0;
+    }
+
+    float getChannelFrequency(uint16_t index) {
+      return 0;
+    }
+
     int16_t setModulation(rfquack_Modulation modulation) {
       return ERR_COMMAND_NOT_IMPLEMENTED;
     }
@@ -156,22 +320,14 @@ public:
 
 private:
     rfquack_Mode _mode = rfquack_Mode_IDLE;
-    Queue *_rxQueue;
     rfquack_WhichRadio _whichRadio;
+    RFQRadioStats _stats;
+    RFQRxOverflow _rxOverflow;
+    RFQTxQueue _txQueue;
 
-    void enqueuePacket(rfquack_Packet *packet) {
-      if (packet->data.size > sizeof(rfquack_Packet)) {
-        Log.error(F("Packet payload is grater than container."));
-        return;
-      }
-
-      if (_rxQueue->isFull()) {
-        Log.error(F("rxQueue is full"));
-        return;
-      }
-
-      _rxQueue->push(packet);
-      RFQUACK_LOG_TRACE(F("Packet put in rxQueue, size %d bytes"), packet->data.size);
+    void enqueuePacket(rfquack_packet_handle_t handle, RFQPacketRing *rxQueue) {
+      if (!enqueueRxPacket(handle, rxQueue, _rxOverflow, _stats)) return;
+      RFQUACK_LOG_TRACE(F("Packet put in rxQueue, size %d bytes"), packetPool.get(handle)->data.size);
     }
 };
 
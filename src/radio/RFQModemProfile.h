@@ -0,0 +1,38 @@
+#ifndef RFQUACK_PROJECT_RFQMODEMPROFILE_H
+#define RFQUACK_PROJECT_RFQMODEMPROFILE_H
+
+#include <stdint.h>
+
+/**
+ * Snapshot of a radio's configuration, as captured by RadioLibWrapper::saveProfile():
+ * the driver's register image, ready to be written back as is, plus the driver state
+ * RadioLib would otherwise compute from the setters (frequency, bit rate, ...).
+ *
+ * Stored as a blob (see RFQProfileStore), bump VERSION whenever the layout changes.
+ */
+struct RFQModemProfile {
+    static const uint8_t VERSION = 1;
+    static const uint8_t IMAGE_SIZE = 64;
+    static const uint8_t EXTRA_SIZE = 8;
+
+    uint8_t version;
+    char chipName[8];       // A profile only loads on the kind of radio it was captured from.
+
+    uint8_t imageLength;
+    uint8_t image[IMAGE_SIZE];
+    uint8_t extra[EXTRA_SIZE];  // Driver specific registers outside the image (e.g. CC1101 PATABLE).
+
+    float freq;
+    float bitRate;
+    float rxBandwidth;
+    int8_t power;
+    uint8_t modulation;
+    bool crcOn;
+    bool promiscuous;
+    uint8_t syncWordLength;
+    uint8_t syncWords[8];
+    uint8_t packetLengthConfig;
+    uint8_t packetLength;
+};
+
+#endif //RFQUACK_PROJECT_RFQMODEMPROFILE_H
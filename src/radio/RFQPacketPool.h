@@ -0,0 +1,207 @@
+#ifndef RFQUACK_PROJECT_RFQPACKETPOOL_H
+#define RFQUACK_PROJECT_RFQPACKETPOOL_H
+
+#include "../rfquack_common.h"
+#include "../defaults/radio.h"
+
+// Handle to a packet slot; the RX queue and buffering modules store these instead of whole packets.
+typedef uint8_t rfquack_packet_handle_t;
+
+#define RFQUACK_PACKET_HANDLE_NONE 0xFF
+
+// Owner of slots not taken by a radio (TX queue, modules): it has no reserved slots.
+#define RFQUACK_PACKET_OWNER_SHARED _rfquack_WhichRadio_ARRAYSIZE
+
+#if RFQUACK_PACKET_POOL_SIZE >= RFQUACK_PACKET_HANDLE_NONE
+#error "RFQUACK_PACKET_POOL_SIZE must be lower than 255."
+#endif
+
+// Radios enabled with "#define USE_RADIOX", each one reserves slots.
+#ifdef USE_RADIOA
+#define _RFQUACK_POOL_RADIOA 1
+#else
+#define _RFQUACK_POOL_RADIOA 0
+#endif
+#ifdef USE_RADIOB
+#define _RFQUACK_POOL_RADIOB 1
+#else
+#define _RFQUACK_POOL_RADIOB 0
+#endif
+#ifdef USE_RADIOC
+#define _RFQUACK_POOL_RADIOC 1
+#else
+#define _RFQUACK_POOL_RADIOC 0
+#endif
+#ifdef USE_RADIOD
+#define _RFQUACK_POOL_RADIOD 1
+#else
+#define _RFQUACK_POOL_RADIOD 0
+#endif
+#ifdef USE_RADIOE
+#define _RFQUACK_POOL_RADIOE 1
+#else
+#define _RFQUACK_POOL_RADIOE 0
+#endif
+#define RFQUACK_PACKET_POOL_RADIOS \
+  (_RFQUACK_POOL_RADIOA + _RFQUACK_POOL_RADIOB + _RFQUACK_POOL_RADIOC + _RFQUACK_POOL_RADIOD + _RFQUACK_POOL_RADIOE)
+
+#if RFQUACK_PACKET_POOL_RESERVED_PER_RADIO * RFQUACK_PACKET_POOL_RADIOS >= RFQUACK_PACKET_POOL_SIZE
+#error "RFQUACK_PACKET_POOL_RESERVED_PER_RADIO times the radios in use leaves no shared packet slots."
+#endif
+
+// When radios are read outside of the main loop the pool is shared between tasks, guard it with a spinlock.
+#ifdef RFQUACK_RADIO_THREADED
+portMUX_TYPE rfquackRxMux = portMUX_INITIALIZER_UNLOCKED;
+#define RFQUACK_RX_ENTER_CRITICAL() portENTER_CRITICAL(&rfquackRxMux);
+#define RFQUACK_RX_EXIT_CRITICAL() portEXIT_CRITICAL(&rfquackRxMux);
+#else
+#define RFQUACK_RX_ENTER_CRITICAL()
+#define RFQUACK_RX_EXIT_CRITICAL()
+#endif
+
+/**
+ * Preallocated, reference counted, pool of packet slots.
+ *
+ * Drivers fill a slot in place, then only its handle travels through the RX queue.
+ * Modules that need to keep a packet around (e.g. RollJam) retain() its handle
+ * instead of copying it, and release() it when done.
+ * Bookkeeping is safe to use from RX tasks (see RFQUACK_RADIO_THREADED).
+ *
+ * Each radio that reserve()s is guaranteed RFQUACK_PACKET_POOL_RESERVED_PER_RADIO slots:
+ * the rest of the pool is shared, and nobody may take the slots other radios still have
+ * in reserve. A chatty radio filling its RX queue can't starve a quiet one.
+ */
+class RFQPacketPool {
+public:
+    /**
+     * Sets aside RFQUACK_PACKET_POOL_RESERVED_PER_RADIO slots for a radio, called once it's set up.
+     * Only what other radios left is given out, always keeping one shared slot.
+     *
+     * @return slots reserved for the radio.
+     */
+    uint8_t reserve(rfquack_WhichRadio whichRadio) {
+      if (whichRadio >= RFQUACK_PACKET_OWNER_SHARED) return 0;
+      RFQUACK_RX_ENTER_CRITICAL()
+      uint16_t others = 0;
+      for (uint8_t i = 0; i < RFQUACK_PACKET_OWNER_SHARED; i++) {
+        if (i != whichRadio) others += _reserved[i];
+      }
+      uint8_t left = others + 1 < RFQUACK_PACKET_POOL_SIZE ? RFQUACK_PACKET_POOL_SIZE - others - 1 : 0;
+      uint8_t reserved = left < RFQUACK_PACKET_POOL_RESERVED_PER_RADIO ? left : RFQUACK_PACKET_POOL_RESERVED_PER_RADIO;
+      _reserved[whichRadio] = reserved;
+      RFQUACK_RX_EXIT_CRITICAL()
+
+      if (reserved < RFQUACK_PACKET_POOL_RESERVED_PER_RADIO) {
+        RFQUACK_LOG_WARN(F("Packet pool: only %d slots left to reserve for radio %d, increase RFQUACK_PACKET_POOL_SIZE."),
+                         reserved, whichRadio)
+      }
+      return reserved;
+    }
+
+    /**
+     * Takes a free slot and zeroes its packet.
+     *
+     * @param owner radio receiving into the slot, RFQUACK_PACKET_OWNER_SHARED for anyone else.
+     * @return handle of the slot, RFQUACK_PACKET_HANDLE_NONE if the pool is exhausted for this owner.
+     */
+    rfquack_packet_handle_t acquire(uint8_t owner = RFQUACK_PACKET_OWNER_SHARED) {
+      rfquack_packet_handle_t handle = RFQUACK_PACKET_HANDLE_NONE;
+      if (owner > RFQUACK_PACKET_OWNER_SHARED) owner = RFQUACK_PACKET_OWNER_SHARED;
+
+      RFQUACK_RX_ENTER_CRITICAL()
+      if (_free > reservedByOthers(owner)) {
+        for (uint8_t i = 0; i < RFQUACK_PACKET_POOL_SIZE; i++) {
+          uint8_t slot = (_next + i) % RFQUACK_PACKET_POOL_SIZE;
+          if (_refs[slot] == 0) {
+            _refs[slot] = 1;
+            _owners[slot] = owner;
+            _held[owner]++;
+            _free--;
+            _next = (slot + 1) % RFQUACK_PACKET_POOL_SIZE;
+            handle = slot;
+            break;
+          }
+        }
+      }
+      RFQUACK_RX_EXIT_CRITICAL()
+
+      if (handle == RFQUACK_PACKET_HANDLE_NONE) {
+        RFQUACK_LOG_ERROR(F("Packet pool is exhausted"))
+        return handle;
+      }
+
+      // Slot is ours now, zero it outside of the critical section.
+      _slots[handle] = rfquack_Packet_init_zero;
+      return handle;
+    }
+
+    /**
+     * Adds a reference to a slot, it won't be reused until every owner releases it.
+     */
+    void retain(rfquack_packet_handle_t handle) {
+      RFQUACK_RX_ENTER_CRITICAL()
+      if (handle < RFQUACK_PACKET_POOL_SIZE && _refs[handle] > 0) {
+        _refs[handle]++;
+      }
+      RFQUACK_RX_EXIT_CRITICAL()
+    }
+
+    /**
+     * Drops a reference to a slot, making it available once unreferenced.
+     */
+    void release(rfquack_packet_handle_t handle) {
+      RFQUACK_RX_ENTER_CRITICAL()
+      if (handle < RFQUACK_PACKET_POOL_SIZE && _refs[handle] > 0 && --_refs[handle] == 0) {
+        _held[_owners[handle]]--;
+        _free++;
+      }
+      RFQUACK_RX_EXIT_CRITICAL()
+    }
+
+    rfquack_Packet *get(rfquack_packet_handle_t handle) {
+      if (handle >= RFQUACK_PACKET_POOL_SIZE) return nullptr;
+      return &_slots[handle];
+    }
+
+    /**
+     * @return handle of the slot holding pkt, RFQUACK_PACKET_HANDLE_NONE if pkt does not belong to the pool.
+     */
+    rfquack_packet_handle_t handleOf(const rfquack_Packet *pkt) const {
+      if (pkt < &_slots[0] || pkt >= &_slots[RFQUACK_PACKET_POOL_SIZE]) return RFQUACK_PACKET_HANDLE_NONE;
+      return (rfquack_packet_handle_t) (pkt - &_slots[0]);
+    }
+
+    uint8_t available() const {
+      return _free;
+    }
+
+    // Slots currently held by an owner (see acquire()).
+    uint8_t held(uint8_t owner) const {
+      return owner <= RFQUACK_PACKET_OWNER_SHARED ? _held[owner] : 0;
+    }
+
+private:
+    static const uint8_t OWNERS = RFQUACK_PACKET_OWNER_SHARED + 1;
+
+    // Free slots that radios other than owner may still claim from their reservation.
+    uint8_t reservedByOthers(uint8_t owner) const {
+      uint16_t reserved = 0;
+      for (uint8_t i = 0; i < RFQUACK_PACKET_OWNER_SHARED; i++) {
+        if (i != owner && _held[i] < _reserved[i]) reserved += _reserved[i] - _held[i];
+      }
+      return reserved > RFQUACK_PACKET_POOL_SIZE ? RFQUACK_PACKET_POOL_SIZE : reserved;
+    }
+
+    rfquack_Packet _slots[RFQUACK_PACKET_POOL_SIZE];
+    uint8_t _refs[RFQUACK_PACKET_POOL_SIZE] = {0};
+    uint8_t _owners[RFQUACK_PACKET_POOL_SIZE] = {0};
+    uint8_t _held[OWNERS] = {0};
+    uint8_t _reserved[OWNERS] = {0};
+    uint8_t _free = RFQUACK_PACKET_POOL_SIZE;
+    uint8_t _next = 0;
+};
+
+// Global packet pool instance.
+RFQPacketPool packetPool;
+
+#endif //RFQUACK_PROJECT_RFQPACKETPOOL_H
@@ -0,0 +1,119 @@
+#ifndef RFQUACK_PROJECT_RFQPACKETRING_H
+#define RFQUACK_PROJECT_RFQPACKETRING_H
+
+#include <atomic>
+#include "RFQPacketPool.h"
+
+/**
+ * Lock-free single-producer / single-consumer ring of packet handles.
+ *
+ * The producer (whoever reads the radios) only writes the head, the consumer
+ * (the loop draining the RX queue) only writes the tail: they can run on
+ * different cores without locks. Multiple producers must serialize push().
+ *
+ * The producer may also evict the oldest handle (see pushEvictingOldest()):
+ * the tail is then advanced with a compare-and-swap by both sides, it carries
+ * a generation counter so a stale tail is never mistaken for a current one.
+ */
+class RFQPacketRing {
+public:
+    /**
+     * Appends a handle, the caller keeps ownership of it if the ring is full.
+     *
+     * @return false if the ring is full (the drop is accounted).
+     */
+    bool push(const rfquack_packet_handle_t *handle) {
+      if (tryPush(handle)) return true;
+      _drops++;
+      return false;
+    }
+
+    /**
+     * Appends a handle, evicting the oldest one if the ring is full.
+     *
+     * @param[out] evicted handle taken out of the ring to make room (the caller owns it),
+     *                     RFQUACK_PACKET_HANDLE_NONE if none.
+     */
+    void pushEvictingOldest(const rfquack_packet_handle_t *handle, rfquack_packet_handle_t *evicted) {
+      *evicted = RFQUACK_PACKET_HANDLE_NONE;
+      while (!tryPush(handle)) {
+        // Consumer may win the race for the oldest handle: then there's room already.
+        if (pop(evicted)) _drops++;
+      }
+    }
+
+    /**
+     * Takes the oldest handle.
+     *
+     * @return false if the ring is empty.
+     */
+    bool pop(rfquack_packet_handle_t *handle) {
+      uint32_t tail = _tail.load(std::memory_order_acquire);
+      for (;;) {
+        uint32_t index = tail & INDEX_MASK;
+        if (index == _head.load(std::memory_order_acquire)) return false;
+
+        rfquack_packet_handle_t candidate = _slots[index];
+        uint32_t next = (tail & ~INDEX_MASK) + GENERATION_STEP + advance(index);
+        if (_tail.compare_exchange_weak(tail, next, std::memory_order_acq_rel)) {
+          *handle = candidate;
+          return true;
+        }
+      }
+    }
+
+    uint32_t getCount() const {
+      uint32_t head = _head.load(std::memory_order_acquire);
+      uint32_t tail = _tail.load(std::memory_order_acquire) & INDEX_MASK;
+      return head >= tail ? head - tail : head + RING_SIZE - tail;
+    }
+
+    bool isFull() const {
+      return getCount() == RFQUACK_RADIO_RX_QUEUE_LEN;
+    }
+
+    // Handles refused or evicted because the ring was full.
+    uint32_t getDrops() const {
+      return _drops;
+    }
+
+    // Highest occupancy seen since boot.
+    uint32_t getHighWater() const {
+      return _highWater;
+    }
+
+private:
+    // One slot is always left empty to tell a full ring from an empty one.
+    static const uint32_t RING_SIZE = RFQUACK_RADIO_RX_QUEUE_LEN + 1;
+
+    // Tail layout: generation in the upper half, slot index in the lower half.
+    static const uint32_t INDEX_MASK = 0xFFFF;
+    static const uint32_t GENERATION_STEP = 0x10000;
+
+    rfquack_packet_handle_t _slots[RING_SIZE];
+    std::atomic<uint32_t> _head{0};
+    std::atomic<uint32_t> _tail{0};
+
+    // Written by the producer only.
+    volatile uint32_t _drops = 0;
+    volatile uint32_t _highWater = 0;
+
+    bool tryPush(const rfquack_packet_handle_t *handle) {
+      uint32_t head = _head.load(std::memory_order_relaxed);
+      uint32_t next = advance(head);
+      if (next == (_tail.load(std::memory_order_acquire) & INDEX_MASK)) return false;
+
+      _slots[head] = *handle;
+      _head.store(next, std::memory_order_release);
+
+      uint32_t count = getCount();
+      if (count > _highWater) _highWater = count;
+      return true;
+    }
+
+    static uint32_t advance(uint32_t index) {
+      return index + 1 == RING_SIZE ? 0 : index + 1;
+    }
+};
+
+#endif //RFQUACK_PROJECT_RFQPACKETRING_H
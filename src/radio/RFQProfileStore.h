@@ -0,0 +1,99 @@
+#ifndef RFQUACK_PROJECT_RFQPROFILESTORE_H
+#define RFQUACK_PROJECT_RFQPROFILESTORE_H
+
+#include <Preferences.h>
+#include <nvs.h>
+#include "../rfquack_common.h"
+#include "../defaults/radio.h"
+#include "RFQModemProfile.h"
+
+/**
+ * Named modem profiles, kept in NVS (one blob per profile, the name is the key),
+ * plus the name of the profile each radio loads at boot.
+ */
+class RFQProfileStore {
+public:
+    // NVS keys are at most 15 characters long.
+    static const uint8_t NAME_MAX_LEN = 15;
+
+    static bool isValidName(const char *name) {
+      size_t len = strlen(name);
+      return len > 0 && len <= NAME_MAX_LEN;
+    }
+
+    static bool save(const char *name, const RFQModemProfile &profile) {
+      Preferences prefs;
+      if (!prefs.begin(RFQUACK_PROFILE_NVS_NAMESPACE, false)) return false;
+      size_t written = prefs.putBytes(name, &profile, sizeof(profile));
+      prefs.end();
+      return written == sizeof(profile);
+    }
+
+    static bool load(const char *name, RFQModemProfile *profile) {
+      Preferences prefs;
+      if (!prefs.begin(RFQUACK_PROFILE_NVS_NAMESPACE, true)) return false;
+      size_t read = 0;
+      if (prefs.getBytesLength(name) == sizeof(*profile)) {
+        read = prefs.getBytes(name, profile, sizeof(*profile));
+      }
+      prefs.end();
+      return read == sizeof(*profile) && profile->version == RFQModemProfile::VERSION;
+    }
+
+    static bool remove(const char *name) {
+      Preferences prefs;
+      if (!prefs.begin(RFQUACK_PROFILE_NVS_NAMESPACE, false)) return false;
+      bool removed = prefs.remove(name);
+      prefs.end();
+      return removed;
+    }
+
+    /**
+     * Writes the names of the stored profiles, comma separated, truncated to fit.
+     *
+     * @return number of stored profiles.
+     */
+    static uint8_t list(char *names, size_t size) {
+      uint8_t count = 0;
+      size_t used = 0;
+      names[0] = '\0';
+
+      nvs_iterator_t it = nvs_entry_find(NVS_DEFAULT_PART_NAME, RFQUACK_PROFILE_NVS_NAMESPACE, NVS_TYPE_BLOB);
+      while (it != NULL) {
+        nvs_entry_info_t info;
+        nvs_entry_info(it, &info);
+        int n = snprintf(names + used, size - used, "%s%s", count > 0 ? ", " : "", info.key);
+        if (n > 0) used = used + n < size ? used + n : size - 1;
+        count++;
+        it = nvs_entry_next(it);
+      }
+      nvs_release_iterator(it);
+      return count;
+    }
+
+    // Profile loaded at boot by a radio, an empty name clears it.
+    static bool setBootProfile(rfquack_WhichRadio whichRadio, const char *name) {
+      Preferences prefs;
+      if (!prefs.begin(RFQUACK_PROFILE_BOOT_NVS_NAMESPACE, false)) return false;
+      char key[2] = {radioKey(whichRadio), '\0'};
+      bool done = strlen(name) == 0 ? (!prefs.isKey(key) || prefs.remove(key)) : prefs.putString(key, name) > 0;
+      prefs.end();
+      return done;
+    }
+
+    static bool getBootProfile(rfquack_WhichRadio whichRadio, char *name, size_t size) {
+      Preferences prefs;
+      if (!prefs.begin(RFQUACK_PROFILE_BOOT_NVS_NAMESPACE, true)) return false;
+      char key[2] = {radioKey(whichRadio), '\0'};
+      bool found = prefs.isKey(key) && prefs.getString(key, name, size) > 0;
+      prefs.end();
+      return found;
+    }
+
+private:
+    static char radioKey(rfquack_WhichRadio whichRadio) {
+      return (char) ('A' + (whichRadio - rfquack_WhichRadio_RadioA));
+    }
+};
+
+#endif //RFQUACK_PROJECT_RFQPROFILESTORE_H
@@ -153,6 +153,16 @@ public:
   //   return RF69::startReceive();
   // }
 
+  uint32_t getRxSettleUs() override
+  {
+    // startReceive() goes through standby: frequency synthesizer wake-up (TS_FS, 60 us)
+    // plus receiver wake-up (TS_RE), roughly inversely proportional to RX bandwidth
+    // (1.7 ms at 10 kHz, see RFM69 datasheet, Table 6).
+    if (RF69::_rxBw <= 0)
+      return 60;
+    return 60 + (uint32_t)(17000.0 / RF69::_rxBw);
+  }
+
   bool isIncomingDataAvailable() override
   {
     // Makes sense only if in RX mode.
@@ -205,6 +215,281 @@ public:
     return RADIOLIB_ERR_NONE;
   }
 
+  int16_t applyModemConfig(rfquack_ModemConfig &cfg) override
+  {
+    // Registers from DataModul to PacketConfig1 in one burst, patched in memory: nothing is written
+    // unless every field is valid. Registers in between are written back as read, harmless in standby.
+    ConfigImage image;
+    _mod->SPIreadRegisterBurst(RADIOLIB_RF69_REG_DATA_MODUL, ConfigImage::LENGTH, image.data());
+
+    float freq = RF69::_freq;
+    float br = RF69::_br;
+    float rxBw = RF69::_rxBw;
+    int8_t power = RF69::_power;
+    bool ook = RF69::_ook;
+    bool promiscuous = RF69::_promiscuous;
+    uint8_t syncWordLength = RF69::_syncWordLength;
+
+    if (cfg.has_carrierFreq)
+    {
+      freq = cfg.carrierFreq;
+      if (!isValidFrequency(freq))
+        return RADIOLIB_ERR_INVALID_FREQUENCY;
+      uint32_t frf = getFrf(freq);
+      image.set(RADIOLIB_RF69_REG_FRF_MSB, (frf & 0xFF0000) >> 16);
+      image.set(RADIOLIB_RF69_REG_FRF_MID, (frf & 0x00FF00) >> 8);
+      image.set(RADIOLIB_RF69_REG_FRF_LSB, frf & 0x0000FF);
+    }
+
+    if (cfg.has_txPower)
+    {
+      // PA settings depend on the module, they're applied by RF69::setOutputPower() once the image is written.
+      power = (int8_t)cfg.txPower;
+#ifndef RF69_NOT_HIGHPOWER
+      if (power < -2 || power > 20)
+#else
+      if (power < -18 || power > 13)
+#endif
+        return RADIOLIB_ERR_INVALID_OUTPUT_POWER;
+    }
+
+    if (cfg.has_preambleLen)
+    {
+      image.set(RADIOLIB_RF69_REG_PREAMBLE_MSB, 0x00);
+      image.set(RADIOLIB_RF69_REG_PREAMBLE_LSB, (uint8_t)cfg.preambleLen / 8);
+    }
+
+    if (cfg.has_syncWords)
+    {
+      if (cfg.syncWords.size == 0)
+      {
+        // As RF69::disableSyncWordFiltering(): no preamble and no sync word.
+        image.set(RADIOLIB_RF69_REG_PREAMBLE_MSB, 0x00);
+        image.set(RADIOLIB_RF69_REG_PREAMBLE_LSB, 0x00);
+        image.set(RADIOLIB_RF69_REG_SYNC_CONFIG, RADIOLIB_RF69_SYNC_OFF | RADIOLIB_RF69_FIFO_FILL_CONDITION, 7, 6);
+      }
+      else
+      {
+        for (pb_size_t i = 0; i < cfg.syncWords.size; i++)
+        {
+          if (cfg.syncWords.bytes[i] == 0x00)
+            return RADIOLIB_ERR_INVALID_SYNC_WORD;
+          image.set(RADIOLIB_RF69_REG_SYNC_VALUE_1 + i, cfg.syncWords.bytes[i]);
+        }
+        promiscuous = false;
+        syncWordLength = cfg.syncWords.size;
+        image.set(RADIOLIB_RF69_REG_SYNC_CONFIG,
+                  RADIOLIB_RF69_SYNC_ON | RADIOLIB_RF69_FIFO_FILL_CONDITION_SYNC | ((syncWordLength - 1) << 3));
+      }
+    }
+
+    if (cfg.has_isPromiscuous && cfg.isPromiscuous != promiscuous)
+    {
+      // As RF69::setPromiscuousMode(): sync word filtering and CRC follow.
+      promiscuous = cfg.isPromiscuous;
+      if (promiscuous)
+      {
+        image.set(RADIOLIB_RF69_REG_PREAMBLE_MSB, 0x00);
+        image.set(RADIOLIB_RF69_REG_PREAMBLE_LSB, 0x00);
+        image.set(RADIOLIB_RF69_REG_SYNC_CONFIG, RADIOLIB_RF69_SYNC_OFF | RADIOLIB_RF69_FIFO_FILL_CONDITION, 7, 6);
+      }
+      else
+      {
+        image.set(RADIOLIB_RF69_REG_SYNC_CONFIG,
+                  RADIOLIB_RF69_SYNC_ON | RADIOLIB_RF69_FIFO_FILL_CONDITION_SYNC | ((syncWordLength - 1) << 3));
+      }
+      image.set(RADIOLIB_RF69_REG_PACKET_CONFIG_1, promiscuous ? RADIOLIB_RF69_CRC_OFF : RADIOLIB_RF69_CRC_ON, 4, 4);
+    }
+
+    if (cfg.has_modulation)
+    {
+      if (cfg.modulation == rfquack_Modulation_OOK)
+        ook = true;
+      else if (cfg.modulation == rfquack_Modulation_FSK2)
+        ook = false;
+      else
+        return RADIOLIB_ERR_UNSUPPORTED_ENCODING;
+      image.set(RADIOLIB_RF69_REG_DATA_MODUL, ook ? RADIOLIB_RF69_OOK : RADIOLIB_RF69_FSK, 4, 3);
+    }
+
+    if (cfg.has_useCRC)
+      image.set(RADIOLIB_RF69_REG_PACKET_CONFIG_1, cfg.useCRC ? RADIOLIB_RF69_CRC_ON : RADIOLIB_RF69_CRC_OFF, 4, 4);
+
+    // RX bandwidth is encoded differently in OOK, a modulation change needs it too.
+    if (cfg.has_rxBandwidth || cfg.has_modulation)
+    {
+      if (cfg.has_rxBandwidth)
+        rxBw = cfg.rxBandwidth;
+      int8_t rxBwValue = getRxBw(rxBw, ook);
+      if (rxBwValue < 0)
+        return RADIOLIB_ERR_INVALID_RX_BANDWIDTH;
+      image.set(RADIOLIB_RF69_REG_RXBW, rxBwValue, 4, 0);
+    }
+
+    if (cfg.has_bitRate || cfg.has_modulation)
+    {
+      if (cfg.has_bitRate)
+        br = cfg.bitRate;
+      if (br < 1.2 || br > 300.0 || (ook && br > 32.768))
+        return RADIOLIB_ERR_INVALID_BIT_RATE;
+      uint16_t bitRate = 32000 / br;
+      image.set(RADIOLIB_RF69_REG_BITRATE_MSB, (bitRate & 0xFF00) >> 8);
+      image.set(RADIOLIB_RF69_REG_BITRATE_LSB, bitRate & 0x00FF);
+    }
+
+    if (cfg.has_frequencyDeviation)
+    {
+      float freqDev = cfg.frequencyDeviation;
+      if (freqDev < 0.0 || freqDev + br / 2 > 500)
+        return RADIOLIB_ERR_INVALID_FREQUENCY_DEVIATION;
+      uint32_t fdev = (uint32_t)((freqDev * (uint32_t(1) << RADIOLIB_RF69_DIV_EXPONENT)) / 32000);
+      image.set(RADIOLIB_RF69_REG_FDEV_MSB, (fdev & 0xFF00) >> 8, 5, 0);
+      image.set(RADIOLIB_RF69_REG_FDEV_LSB, fdev & 0x00FF);
+    }
+
+    // Configuration is written in standby.
+    int16_t state = RF69::setMode(RADIOLIB_RF69_STANDBY);
+    if (state != RADIOLIB_ERR_NONE)
+      return state;
+    if (image.getDirtyLength() > 0)
+      _mod->SPIwriteRegisterBurst(image.getDirtyFirst(), image.getDirty(), image.getDirtyLength());
+
+    RF69::_freq = freq;
+    RF69::_br = br;
+    RF69::_rxBw = rxBw;
+    RF69::_ook = ook;
+    RF69::_promiscuous = promiscuous;
+    RF69::_syncWordLength = syncWordLength;
+    if (cfg.has_syncWords)
+      memcpy(_syncWords, cfg.syncWords.bytes, cfg.syncWords.size);
+
+    if (cfg.has_txPower)
+      state = setOutputPower((uint32_t)power);
+
+    if (state == RADIOLIB_ERR_NONE && _mode == rfquack_Mode_RX)
+      state = RF69::startReceive();
+
+    return state;
+  }
+
+  int16_t captureProfile(RFQModemProfile &profile) override
+  {
+    // Registers from DataModul to PacketConfig2: modem, PA, RX and packet engine settings.
+    profile.imageLength = PROFILE_IMAGE_LAST - RADIOLIB_RF69_REG_DATA_MODUL + 1;
+    _mod->SPIreadRegisterBurst(RADIOLIB_RF69_REG_DATA_MODUL, profile.imageLength, profile.image);
+
+    profile.freq = RF69::_freq;
+    profile.bitRate = RF69::_br;
+    profile.rxBandwidth = RF69::_rxBw;
+    profile.power = RF69::_power;
+    profile.modulation = RF69::_ook;
+    profile.promiscuous = RF69::_promiscuous;
+    profile.syncWordLength = RF69::_syncWordLength;
+    memcpy(profile.syncWords, _syncWords, sizeof(_syncWords));
+    profile.packetLengthConfig = RF69::_packetLengthConfig;
+    profile.packetLength = RF69::_packetLength;
+    return RADIOLIB_ERR_NONE;
+  }
+
+  int16_t restoreProfile(const RFQModemProfile &profile) override
+  {
+    if (profile.imageLength != PROFILE_IMAGE_LAST - RADIOLIB_RF69_REG_DATA_MODUL + 1)
+      return ERR_PROFILE_MISMATCH;
+
+    // Configuration is written in standby. Flags and DIO mapping in the image are set again by RX / TX.
+    int16_t state = RF69::setMode(RADIOLIB_RF69_STANDBY);
+    if (state != RADIOLIB_ERR_NONE)
+      return state;
+    _mod->SPIwriteRegisterBurst(RADIOLIB_RF69_REG_DATA_MODUL, const_cast<uint8_t *>(profile.image), profile.imageLength);
+
+    RF69::_freq = profile.freq;
+    RF69::_br = profile.bitRate;
+    RF69::_rxBw = profile.rxBandwidth;
+    RF69::_power = profile.power;
+    RF69::_ook = profile.modulation;
+    RF69::_promiscuous = profile.promiscuous;
+    RF69::_syncWordLength = profile.syncWordLength;
+    memcpy(_syncWords, profile.syncWords, sizeof(_syncWords));
+    RF69::_packetLengthConfig = profile.packetLengthConfig;
+    RF69::_packetLength = profile.packetLength;
+
+    if (_mode == rfquack_Mode_RX)
+      state = RF69::startReceive();
+    return state;
+  }
+
+  int16_t compileChannel(float freq, RFQChannel &channel) override
+  {
+    if (!isValidFrequency(freq))
+      return RADIOLIB_ERR_INVALID_FREQUENCY;
+
+    // FRF only: the synthesizer locks on its own when the frequency changes.
+    uint32_t frf = getFrf(freq);
+    channel.freq = freq;
+    channel.length = 3;
+    channel.image[0] = (frf & 0xFF0000) >> 16;
+    channel.image[1] = (frf & 0x00FF00) >> 8;
+    channel.image[2] = frf & 0x0000FF;
+    return RADIOLIB_ERR_NONE;
+  }
+
+  int16_t writeChannel(const RFQChannel &channel) override
+  {
+    _mod->SPIwriteRegisterBurst(RADIOLIB_RF69_REG_FRF_MSB, const_cast<uint8_t *>(channel.image), 3);
+    RF69::_freq = channel.freq;
+
+    // While receiving the new frequency is used once RX restarts.
+    if (_mode == rfquack_Mode_RX)
+    {
+      uint8_t packetConfig2 = _mod->SPIreadRegister(RADIOLIB_RF69_REG_PACKET_CONFIG_2);
+      _mod->SPIwriteRegister(RADIOLIB_RF69_REG_PACKET_CONFIG_2, packetConfig2 | RF69_RESTART_RX);
+    }
+    return RADIOLIB_ERR_NONE;
+  }
+
+  int16_t stageFrame(uint8_t *data, size_t len) override
+  {
+    if (len > RADIOLIB_RF69_MAX_PACKET_LENGTH)
+      return RADIOLIB_ERR_PACKET_TOO_LONG;
+
+    // Same as RF69::startTransmit(), but the chip is left in FS mode (synthesizer locked) with the FIFO loaded.
+    int16_t state = RF69::setMode(RADIOLIB_RF69_STANDBY);
+    state |= _mod->SPIsetRegValue(RADIOLIB_RF69_REG_DIO_MAPPING_1, RADIOLIB_RF69_DIO0_PACK_PACKET_SENT, 7, 6);
+    if (state != RADIOLIB_ERR_NONE)
+      return state;
+    RF69::clearIRQFlags();
+
+    if (RF69::_packetLengthConfig == RADIOLIB_RF69_PACKET_FORMAT_VARIABLE)
+      _mod->SPIwriteRegister(RADIOLIB_RF69_REG_FIFO, (uint8_t)len);
+    _mod->SPIwriteRegisterBurst(RADIOLIB_RF69_REG_FIFO, data, len);
+
+    // Enable +20 dBm operation
+    if (RF69::_power > 17)
+    {
+      state |= _mod->SPIsetRegValue(RADIOLIB_RF69_REG_TEST_PA1, RADIOLIB_RF69_PA1_20_DBM, 7, 0);
+      state |= _mod->SPIsetRegValue(RADIOLIB_RF69_REG_TEST_PA2, RADIOLIB_RF69_PA2_20_DBM, 7, 0);
+    }
+
+    state |= RF69::setMode(RADIOLIB_RF69_FS);
+    return state;
+  }
+
+  int16_t fireFrame() override
+  {
+    int16_t state = RF69::setMode(RADIOLIB_RF69_TX);
+    if (state != RADIOLIB_ERR_NONE)
+      return state;
+
+    // TxReady is set once the PA has ramped up.
+    uint32_t start = micros();
+    while (!(_mod->SPIreadRegister(RADIOLIB_RF69_REG_IRQ_FLAGS_1) & RADIOLIB_RF69_TX_READY))
+    {
+      if (micros() - start > RF69_FIRE_TIMEOUT_US)
+        return RADIOLIB_ERR_TX_TIMEOUT;
+    }
+    return RADIOLIB_ERR_NONE;
+  }
+
   // TODO implement jamMode for RFM69
   int16_t jamMode()
   {
@@ -233,9 +518,37 @@ public:
     return *rssi;
   }
 
-  void writeRegister(rfquack_register_address_t reg, rfquack_register_value_t value, uint8_t msb, uint8_t lsb) override
+  bool isVolatileRegister(uint8_t reg) override
+  {
+    // FIFO, OpMode, AFC / FEI / RSSI / IRQ flags and DIO mapping (rewritten when RX restarts),
+    // temperature and PA test registers (rewritten by RX / TX).
+    return reg == RADIOLIB_RF69_REG_FIFO || reg == RADIOLIB_RF69_REG_OP_MODE ||
+           (reg >= RADIOLIB_RF69_REG_AFC_MSB && reg <= RADIOLIB_RF69_REG_IRQ_FLAGS_2) ||
+           reg == RADIOLIB_RF69_REG_TEMP_1 || reg == RADIOLIB_RF69_REG_TEMP_2 ||
+           reg == RADIOLIB_RF69_REG_TEST_PA1 || reg == RADIOLIB_RF69_REG_TEST_PA2;
+  }
+
+  int16_t spiReadRegisterBurst(uint8_t first, uint8_t len, uint8_t *values) override
   {
-    _mod->SPIsetRegValue((uint8_t)reg, (uint8_t)value, msb, lsb, 0);
+    // A burst at the FIFO address stays on the FIFO and reading it would eat received bytes: skip it.
+    if (first == RADIOLIB_RF69_REG_FIFO)
+    {
+      values[0] = 0;
+      first++;
+      values++;
+      len--;
+    }
+    if (len > 0)
+      _mod->SPIreadRegisterBurst(first, len, values);
+    return RADIOLIB_ERR_NONE;
+  }
+
+  int16_t spiWriteRegisterBurst(uint8_t first, uint8_t len, const uint8_t *values) override
+  {
+    if (first == RADIOLIB_RF69_REG_FIFO)
+      return ERR_INVALID_REGISTER;
+    _mod->SPIwriteRegisterBurst(first, const_cast<uint8_t *>(values), len);
+    return RADIOLIB_ERR_NONE;
   }
 
   void removeInterrupts() override
@@ -252,7 +565,46 @@ public:
   }
 
 private:
-    byte _syncWords[RADIOLIB_RF69_DEFAULT_SW_LEN] = RADIOLIB_RF69_DEFAULT_SW;
+    // Max time from entering TX to TxReady (us).
+    static const uint32_t RF69_FIRE_TIMEOUT_US = 1000;
+
+    // RestartRx bit of PacketConfig2, cleared by the chip.
+    static const uint8_t RF69_RESTART_RX = 0x04;
+
+    // Last register captured in profiles.
+    static const uint8_t PROFILE_IMAGE_LAST = RADIOLIB_RF69_REG_PACKET_CONFIG_2;
+
+    // Registers from DataModul to PacketConfig1.
+    typedef RFQRegisterImage<RADIOLIB_RF69_REG_DATA_MODUL, RADIOLIB_RF69_REG_PACKET_CONFIG_1 - RADIOLIB_RF69_REG_DATA_MODUL + 1> ConfigImage;
+
+    static bool isValidFrequency(float freq)
+    {
+      return (freq > 290.0 && freq < 340.0) || (freq > 431.0 && freq < 510.0) || (freq > 862.0 && freq < 1020.0);
+    }
+
+    // FrfMsb:FrfMid:FrfLsb for a frequency in MHz.
+    static uint32_t getFrf(float freq)
+    {
+      return (uint32_t)((freq * (uint32_t(1) << RADIOLIB_RF69_DIV_EXPONENT)) / RADIOLIB_RF69_CRYSTAL_FREQ);
+    }
+
+    // RxBw RxBwMant:RxBwExp for a RX bandwidth in kHz, -1 if unsupported (see RF69::setRxBandwidth()).
+    static int8_t getRxBw(float rxBw, bool ook)
+    {
+      for (int8_t e = 7; e >= 0; e--)
+      {
+        for (int8_t m = 2; m >= 0; m--)
+        {
+          float point = (RADIOLIB_RF69_CRYSTAL_FREQ * 1000000.0) / (((4 * m) + 16) * ((uint32_t)1 << (e + (ook ? 3 : 2))));
+          if (fabs(rxBw - (point / 1000.0)) <= 0.1)
+            return (m << 3) | e;
+        }
+      }
+      return -1;
+    }
+
+    // Sync words are up to 8 bytes long.
+    byte _syncWords[8] = RADIOLIB_RF69_DEFAULT_SW;
 };
 
 #endif //RFQUACK_PROJECT_RFQRF69_H
@@ -0,0 +1,17 @@
+#ifndef RFQUACK_PROJECT_RFQRADIOSNAPSHOT_H
+#define RFQUACK_PROJECT_RFQRADIOSNAPSHOT_H
+
+#include "../rfquack_common.h"
+#include "RFQModemProfile.h"
+
+/**
+ * State of a radio taken by RadioLibWrapper::takeSnapshot(), to borrow the radio and hand it back
+ * as it was: its register image (captured with burst reads, as a profile) and the mode it was in.
+ */
+struct RFQRadioSnapshot {
+    bool taken = false;
+    rfquack_Mode mode = rfquack_Mode_IDLE;
+    RFQModemProfile profile;
+};
+
+#endif //RFQUACK_PROJECT_RFQRADIOSNAPSHOT_H
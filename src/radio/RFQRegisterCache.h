@@ -0,0 +1,113 @@
+#ifndef RFQUACK_PROJECT_RFQREGISTERCACHE_H
+#define RFQUACK_PROJECT_RFQREGISTERCACHE_H
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Shadow of a radio's configuration registers, plus the masked writes not yet sent to the chip.
+ *
+ * Values are known only after being read from or fully written to the chip, and are forgotten
+ * (invalidate()) whenever something else may have touched the chip (setters, mode changes, TX).
+ * Masked writes to the same address are merged into a single pending write, sent by the driver
+ * in the order the addresses were first written (see RadioLibWrapper::flushRegisters()).
+ */
+class RFQRegisterCache {
+public:
+    // Addresses at or above this one are never cached.
+    static const uint16_t SIZE = 128;
+
+    static bool isCacheable(uint8_t reg) {
+      return reg < SIZE;
+    }
+
+    /**
+     * @param[out] value known register content.
+     * @return false if the content is unknown.
+     */
+    bool get(uint8_t reg, uint8_t *value) const {
+      if (!isCacheable(reg) || !testBit(_known, reg)) return false;
+      *value = _values[reg];
+      return true;
+    }
+
+    // Records the content of a register, as read from or written to the chip.
+    void set(uint8_t reg, uint8_t value) {
+      if (!isCacheable(reg)) return;
+      _values[reg] = value;
+      setBit(_known, reg);
+    }
+
+    // Forgets every known value, pending writes are kept.
+    void invalidate() {
+      memset(_known, 0, sizeof(_known));
+    }
+
+    /**
+     * Merges a masked write in the pending write of its address.
+     *
+     * @param value already positioned in the register (as for SPIsetRegValue()).
+     * @param mask bits to write.
+     * @return true if it was merged in an existing pending write.
+     */
+    bool stage(uint8_t reg, uint8_t value, uint8_t mask) {
+      bool merged = _pendingMasks[reg] != 0;
+      if (!merged) _pendingOrder[_pendingCount++] = reg;
+      _pendingValues[reg] = (_pendingValues[reg] & ~mask) | (value & mask);
+      _pendingMasks[reg] |= mask;
+      return merged;
+    }
+
+    bool isPending(uint8_t reg) const {
+      return isCacheable(reg) && _pendingMasks[reg] != 0;
+    }
+
+    uint8_t getPendingCount() const {
+      return _pendingCount;
+    }
+
+    // Address of the i-th pending write, in first write order.
+    uint8_t getPending(uint8_t i) const {
+      return _pendingOrder[i];
+    }
+
+    uint8_t getPendingValue(uint8_t reg) const {
+      return _pendingValues[reg];
+    }
+
+    uint8_t getPendingMask(uint8_t reg) const {
+      return _pendingMasks[reg];
+    }
+
+    // Drops the pending write of an address, once sent.
+    void clearPending(uint8_t reg) {
+      if (_pendingMasks[reg] == 0) return;
+      _pendingMasks[reg] = 0;
+      _pendingValues[reg] = 0;
+      for (uint8_t i = 0; i < _pendingCount; i++) {
+        if (_pendingOrder[i] != reg) continue;
+        memmove(&_pendingOrder[i], &_pendingOrder[i + 1], _pendingCount - i - 1);
+        _pendingCount--;
+        break;
+      }
+    }
+
+private:
+    uint8_t _values[SIZE] = {0};
+    uint32_t _known[SIZE / 32] = {0};
+
+    uint8_t _pendingValues[SIZE] = {0};
+    uint8_t _pendingMasks[SIZE] = {0};
+    uint8_t _pendingOrder[SIZE];
+    uint8_t _pendingCount = 0;
+
+    static bool testBit(const uint32_t *bits, uint8_t i) {
+      return bits[i / 32] & (1UL << (i % 32));
+    }
+
+    static void setBit(uint32_t *bits, uint8_t i) {
+      bits[i / 32] |= (1UL << (i % 32));
+    }
+};
+
+#endif //RFQUACK_PROJECT_RFQREGISTERCACHE_H
@@ -0,0 +1,71 @@
+#ifndef RFQUACK_PROJECT_RFQREGISTERIMAGE_H
+#define RFQUACK_PROJECT_RFQREGISTERIMAGE_H
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Copy of a contiguous range of a radio's registers, edited in memory and then written back to
+ * the chip with a single burst covering only the registers that actually changed.
+ *
+ * Used to apply a whole rfquack_ModemConfig at once (see RadioLibWrapper::applyModemConfig()):
+ * the image is read in one burst, every field is compiled and validated against it, and nothing
+ * reaches the chip unless all of them succeeded.
+ */
+template<uint8_t BASE, uint8_t SIZE>
+class RFQRegisterImage {
+public:
+    static const uint8_t LENGTH = SIZE;
+
+    // Buffer to be filled by a burst read of LENGTH registers starting at BASE.
+    uint8_t *data() {
+      return _values;
+    }
+
+    uint8_t get(uint8_t reg) const {
+      return _values[reg - BASE];
+    }
+
+    /**
+     * Writes some bits of a register, keeping the other ones.
+     *
+     * @param value already positioned in the register (as for SPIsetRegValue()).
+     */
+    void set(uint8_t reg, uint8_t value, uint8_t msb = 7, uint8_t lsb = 0) {
+      uint8_t mask = (uint8_t) ((0xFF << lsb) & (0xFF >> (7 - msb)));
+      uint8_t &current = _values[reg - BASE];
+      uint8_t next = (current & ~mask) | (value & mask);
+      if (next == current) return;
+      current = next;
+      if (_dirtyLength == 0) {
+        _dirtyFirst = reg;
+        _dirtyLength = 1;
+      } else if (reg < _dirtyFirst) {
+        _dirtyLength += _dirtyFirst - reg;
+        _dirtyFirst = reg;
+      } else if (reg >= _dirtyFirst + _dirtyLength) {
+        _dirtyLength = reg - _dirtyFirst + 1;
+      }
+    }
+
+    // First address of the changed range.
+    uint8_t getDirtyFirst() const {
+      return _dirtyFirst;
+    }
+
+    // Registers to burst write, from getDirtyFirst() (0 if nothing changed).
+    uint8_t getDirtyLength() const {
+      return _dirtyLength;
+    }
+
+    uint8_t *getDirty() {
+      return &_values[_dirtyFirst - BASE];
+    }
+
+private:
+    uint8_t _values[SIZE] = {0};
+    uint8_t _dirtyFirst = BASE;
+    uint8_t _dirtyLength = 0;
+};
+
+#endif //RFQUACK_PROJECT_RFQREGISTERIMAGE_H
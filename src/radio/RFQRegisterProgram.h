@@ -0,0 +1,207 @@
+#ifndef RFQUACK_PROJECT_RFQREGISTERPROGRAM_H
+#define RFQUACK_PROJECT_RFQREGISTERPROGRAM_H
+
+#include <esp_timer.h>
+#include "RadioLibWrapper.h"
+#include "../defaults/radio.h"
+
+/**
+ * Interpreter of register micro-programs: a sequence of register accesses, delays, mode changes
+ * and RSSI samples run on the device in one go, so that a tuning experiment costs a single round
+ * trip with the host. Reads and samples append one byte each to the results.
+ *
+ * Instructions (opcode, then operands, one byte each unless noted):
+ *   WRITE  reg value           writes a register.
+ *   UPDATE reg bits value      writes bits msb..lsb of a register, bits = msb << 4 | lsb.
+ *   READ   reg                 appends the register value.
+ *   ADD    reg step            adds step to a register (wrapping), to sweep a setting.
+ *   DELAY  us (2 bytes, LE)    waits, after sending pending register writes.
+ *   MODE   mode                puts the radio in a rfquack_Mode.
+ *   RSSI                       appends the RSSI, in dBm (signed byte).
+ *   REPEAT count               runs the instructions up to the matching NEXT count times.
+ *   NEXT
+ *
+ * Runs on any radio bridge with RFQRadio's register, mode and RSSI methods.
+ */
+class RFQRegisterProgram {
+public:
+    enum Opcode : uint8_t {
+        OP_WRITE = 0x01,
+        OP_UPDATE = 0x02,
+        OP_READ = 0x03,
+        OP_ADD = 0x04,
+        OP_DELAY = 0x05,
+        OP_MODE = 0x06,
+        OP_RSSI = 0x07,
+        OP_REPEAT = 0x08,
+        OP_NEXT = 0x09
+    };
+
+    // Nested REPEAT blocks.
+    static const uint8_t MAX_DEPTH = 4;
+
+    /**
+     * Checks opcodes, operands and REPEAT / NEXT nesting, without running anything.
+     *
+     * @return \ref status_codes (\ref ERR_NONE or \ref ERR_INVALID_PROGRAM)
+     */
+    static int16_t validate(const uint8_t *program, size_t len) {
+      uint8_t depth = 0;
+      size_t pc = 0;
+
+      while (pc < len) {
+        uint8_t opcode = program[pc++];
+        uint8_t operands = getOperandCount(opcode);
+        if (operands == INVALID || pc + operands > len) return ERR_INVALID_PROGRAM;
+        const uint8_t *arg = &program[pc];
+        pc += operands;
+
+        switch (opcode) {
+          case OP_UPDATE:
+            if ((arg[1] >> 4) > 7 || (arg[1] & 0x0F) > (arg[1] >> 4)) return ERR_INVALID_PROGRAM;
+            break;
+          case OP_MODE:
+            if (arg[0] > rfquack_Mode_JAM) return ERR_INVALID_PROGRAM;
+            break;
+          case OP_REPEAT:
+            if (depth == MAX_DEPTH || arg[0] == 0) return ERR_INVALID_PROGRAM;
+            depth++;
+            break;
+          case OP_NEXT:
+            if (depth == 0) return ERR_INVALID_PROGRAM;
+            depth--;
+            break;
+        }
+      }
+      return depth == 0 ? RADIOLIB_ERR_NONE : ERR_INVALID_PROGRAM;
+    }
+
+    /**
+     * Runs a program on a radio, stopping at the first error.
+     * The program is validated first: a malformed one doesn't touch the radio.
+     *
+     * @param results filled with the values read and sampled.
+     * @param resultsLen set to the number of results, also when the program fails.
+     *
+     * @return \ref status_codes (\ref ERR_NONE, \ref ERR_INVALID_PROGRAM, \ref ERR_PROGRAM_TOO_LONG
+     * if results don't fit or RFQUACK_REGISTER_PROGRAM_MAX_US is exceeded, or the error of a mode change)
+     */
+    template<typename R>
+    static int16_t run(R *radio, rfquack_WhichRadio whichRadio, const uint8_t *program, size_t len,
+                       uint8_t *results, size_t resultsSize, size_t *resultsLen) {
+      struct Loop {
+          size_t start;
+          uint8_t left;
+      } loops[MAX_DEPTH];
+      uint8_t depth = 0;
+      size_t pc = 0;
+      *resultsLen = 0;
+
+      int16_t state = validate(program, len);
+      if (state != RADIOLIB_ERR_NONE) return state;
+
+      uint64_t start = esp_timer_get_time();
+
+      while (pc < len) {
+        if (esp_timer_get_time() - start > RFQUACK_REGISTER_PROGRAM_MAX_US) return ERR_PROGRAM_TOO_LONG;
+
+        uint8_t opcode = program[pc++];
+        uint8_t operands = getOperandCount(opcode);
+        if (operands == INVALID || pc + operands > len) return ERR_INVALID_PROGRAM;
+        const uint8_t *arg = &program[pc];
+        pc += operands;
+
+        switch (opcode) {
+          case OP_WRITE:
+            radio->writeRegister(arg[0], arg[1], whichRadio);
+            break;
+
+          case OP_UPDATE: {
+            uint8_t msb = arg[1] >> 4;
+            uint8_t lsb = arg[1] & 0x0F;
+            if (msb > 7 || lsb > msb) return ERR_INVALID_PROGRAM;
+            radio->writeRegister(arg[0], arg[2], msb, lsb, whichRadio);
+            break;
+          }
+
+          case OP_READ:
+            if (*resultsLen >= resultsSize) return ERR_PROGRAM_TOO_LONG;
+            results[(*resultsLen)++] = (uint8_t) radio->readRegister(arg[0], whichRadio);
+            break;
+
+          case OP_ADD: {
+            uint8_t value = (uint8_t) radio->readRegister(arg[0], whichRadio);
+            radio->writeRegister(arg[0], (uint8_t) (value + arg[1]), whichRadio);
+            break;
+          }
+
+          case OP_DELAY:
+            radio->flushRegisters(whichRadio);
+            delayMicroseconds(arg[0] | (arg[1] << 8));
+            break;
+
+          case OP_MODE: {
+            if (arg[0] > rfquack_Mode_JAM) return ERR_INVALID_PROGRAM;
+            int16_t state = radio->setMode((rfquack_Mode) arg[0], whichRadio);
+            if (state != RADIOLIB_ERR_NONE) return state;
+            break;
+          }
+
+          case OP_RSSI: {
+            if (*resultsLen >= resultsSize) return ERR_PROGRAM_TOO_LONG;
+            radio->flushRegisters(whichRadio);
+            float rssi;
+            if (radio->getRSSI(&rssi, whichRadio) == ERR_COMMAND_NOT_IMPLEMENTED) return ERR_COMMAND_NOT_IMPLEMENTED;
+            int16_t dbm = (int16_t) rssi;
+            results[(*resultsLen)++] = (uint8_t) (int8_t) (dbm < -128 ? -128 : (dbm > 127 ? 127 : dbm));
+            break;
+          }
+
+          case OP_REPEAT:
+            if (depth == MAX_DEPTH || arg[0] == 0) return ERR_INVALID_PROGRAM;
+            loops[depth].start = pc;
+            loops[depth].left = arg[0];
+            depth++;
+            break;
+
+          case OP_NEXT:
+            if (depth == 0) return ERR_INVALID_PROGRAM;
+            if (--loops[depth - 1].left > 0) {
+              pc = loops[depth - 1].start;
+            } else {
+              depth--;
+            }
+            break;
+        }
+      }
+
+      // Leave the registers as the program wrote them.
+      radio->flushRegisters(whichRadio);
+      return depth == 0 ? RADIOLIB_ERR_NONE : ERR_INVALID_PROGRAM;
+    }
+
+private:
+    static const uint8_t INVALID = 0xFF;
+
+    static uint8_t getOperandCount(uint8_t opcode) {
+      switch (opcode) {
+        case OP_WRITE:
+        case OP_ADD:
+        case OP_DELAY:
+          return 2;
+        case OP_UPDATE:
+          return 3;
+        case OP_READ:
+        case OP_MODE:
+        case OP_REPEAT:
+          return 1;
+        case OP_RSSI:
+        case OP_NEXT:
+          return 0;
+        default:
+          return INVALID;
+      }
+    }
+};
+
+#endif //RFQUACK_PROJECT_RFQREGISTERPROGRAM_H
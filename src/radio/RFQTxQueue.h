@@ -0,0 +1,165 @@
+#ifndef RFQUACK_PROJECT_RFQTXQUEUE_H
+#define RFQUACK_PROJECT_RFQTXQUEUE_H
+
+#include "../rfquack_common.h"
+#include "../defaults/radio.h"
+#include "RFQPacketPool.h"
+
+/**
+ * A packet to be sent 'repeat' times, when to send it, and how it is going.
+ */
+typedef struct RFQTxJob {
+    uint32_t id;
+    rfquack_packet_handle_t handle;
+    uint32_t remaining;
+    uint32_t sent;
+    uint32_t failed;
+
+    // When the next frame is due (us since boot, esp_timer_get_time()), 0 to send it as soon as possible.
+    uint64_t dueUs;
+    // Time between the start of two repetitions (us), 0 to repeat as fast as possible.
+    uint32_t gapUs;
+    // Worst lateness of a scheduled frame of this job (us).
+    uint32_t jitterMaxUs;
+} RFQTxJob;
+
+/**
+ * Per radio queue of transmission jobs, and reports of the completed ones.
+ *
+ * The radio driver works on the job at the front (see RadioLibWrapper::txLoop()),
+ * completed jobs are turned into a rfquack_TxReport to be published.
+ * Packets are held in the packet pool, a packet already in the pool is retained, not copied.
+ *
+ * A packet may be scheduled: at an absolute time (txAtUs), or txDelayUs after the previous
+ * queued frame was due (after queueing, if the queue is empty or the previous frame was not scheduled).
+ * Repetitions are repeatGapUs apart, computed from the due time so that gaps don't drift.
+ */
+class RFQTxQueue {
+public:
+    /**
+     * Queues a packet for transmission.
+     *
+     * @param pkt packet to send, repeated pkt->repeat times (once if not set).
+     * @param[out] jobId id of the job, reported back on completion.
+     *
+     * @return \ref status_codes
+     */
+    int16_t enqueue(rfquack_Packet *pkt, uint32_t *jobId) {
+      if (_jobsCount == RFQUACK_RADIO_TX_QUEUE_LEN) {
+        RFQUACK_LOG_ERROR(F("TX queue is full"))
+        return ERR_TX_QUEUE_FULL;
+      }
+
+      rfquack_packet_handle_t handle = packetPool.handleOf(pkt);
+      if (handle != RFQUACK_PACKET_HANDLE_NONE) {
+        packetPool.retain(handle);
+      } else {
+        handle = packetPool.acquire();
+        if (handle == RFQUACK_PACKET_HANDLE_NONE) return ERR_TX_QUEUE_FULL;
+        *packetPool.get(handle) = *pkt;
+      }
+
+      RFQTxJob &job = _jobs[(_jobsHead + _jobsCount) % RFQUACK_RADIO_TX_QUEUE_LEN];
+      job.id = _nextJobId++;
+      job.handle = handle;
+      job.remaining = pkt->has_repeat ? pkt->repeat : 1;
+      job.sent = 0;
+      job.failed = 0;
+      job.gapUs = pkt->has_repeatGapUs ? pkt->repeatGapUs : 0;
+      job.jitterMaxUs = 0;
+
+      uint64_t now = esp_timer_get_time();
+      if (pkt->has_txAtUs) {
+        job.dueUs = pkt->txAtUs;
+      } else if (pkt->has_txDelayUs) {
+        job.dueUs = (_jobsCount > 0 && _lastDueUs != 0 ? _lastDueUs : now) + pkt->txDelayUs;
+      } else {
+        job.dueUs = 0;
+      }
+
+      // Remember when the last frame of this job is due, a relative delay of the next job counts from it.
+      _lastDueUs = job.dueUs == 0 ? 0 : job.dueUs + (uint64_t) job.gapUs * (job.remaining - 1);
+      _jobsCount++;
+
+      if (jobId != nullptr) *jobId = job.id;
+      return RADIOLIB_ERR_NONE;
+    }
+
+    /**
+     * @return job being transmitted, nullptr if there's none.
+     */
+    RFQTxJob *front() {
+      if (_jobsCount == 0) return nullptr;
+      return &_jobs[_jobsHead];
+    }
+
+    rfquack_Packet *packetOf(RFQTxJob *job) {
+      return packetPool.get(job->handle);
+    }
+
+    /**
+     * Moves the schedule of a job to its next frame, once a frame was started (or given up) at 'now'.
+     */
+    static void advance(RFQTxJob *job, uint64_t now) {
+      if (job->gapUs == 0) {
+        // Following repetitions go as fast as possible.
+        job->dueUs = 0;
+      } else {
+        job->dueUs = (job->dueUs == 0 ? now : job->dueUs) + job->gapUs;
+      }
+    }
+
+    /**
+     * Removes the job at the front, releasing its packet and recording its report.
+     * If reports are not collected, the oldest one is overwritten.
+     */
+    void complete() {
+      RFQTxJob *job = front();
+      if (job == nullptr) return;
+
+      rfquack_TxReport &report = _reports[(_reportsHead + _reportsCount) % RFQUACK_RADIO_TX_QUEUE_LEN];
+      report = rfquack_TxReport_init_zero;
+      report.jobId = job->id;
+      report.sent = job->sent;
+      report.failed = job->failed;
+      if (job->jitterMaxUs > 0) {
+        report.jitterMaxUs = job->jitterMaxUs;
+        report.has_jitterMaxUs = true;
+      }
+      if (_reportsCount == RFQUACK_RADIO_TX_QUEUE_LEN) {
+        _reportsHead = (_reportsHead + 1) % RFQUACK_RADIO_TX_QUEUE_LEN;
+      } else {
+        _reportsCount++;
+      }
+
+      packetPool.release(job->handle);
+      _jobsHead = (_jobsHead + 1) % RFQUACK_RADIO_TX_QUEUE_LEN;
+      _jobsCount--;
+    }
+
+    /**
+     * Takes the oldest report of a completed job.
+     *
+     * @return false if there's none.
+     */
+    bool popReport(rfquack_TxReport *report) {
+      if (_reportsCount == 0) return false;
+      *report = _reports[_reportsHead];
+      _reportsHead = (_reportsHead + 1) % RFQUACK_RADIO_TX_QUEUE_LEN;
+      _reportsCount--;
+      return true;
+    }
+
+private:
+    RFQTxJob _jobs[RFQUACK_RADIO_TX_QUEUE_LEN];
+    uint8_t _jobsHead = 0;
+    uint8_t _jobsCount = 0;
+    uint32_t _nextJobId = 1;
+    uint64_t _lastDueUs = 0;
+
+    rfquack_TxReport _reports[RFQUACK_RADIO_TX_QUEUE_LEN];
+    uint8_t _reportsHead = 0;
+    uint8_t _reportsCount = 0;
+};
+
+#endif //RFQUACK_PROJECT_RFQTXQUEUE_H
@@ -36,6 +36,40 @@ public:
       return RadioLibWrapper::isTxChannelFree();
     }
 
+    bool isTransmitSuccessful() override {
+      // IRQ is asserted either on ACK (or no ACK needed) or after max retransmits.
+      return !nRF24::getStatus(RADIOLIB_NRF24_MAX_RT);
+    }
+
+    int16_t stageFrame(uint8_t *data, size_t len) override {
+      if (len > RADIOLIB_NRF24_MAX_PACKET_LENGTH) return RADIOLIB_ERR_PACKET_TOO_LONG;
+
+      // Same as nRF24::startTransmit() but CE is left low: the chip waits in Standby-I with the payload loaded.
+      int16_t state = nRF24::standby();
+      state |= _mod->SPIsetRegValue(RADIOLIB_NRF24_REG_CONFIG, RADIOLIB_NRF24_PTX, 0, 0);
+      if (state != RADIOLIB_ERR_NONE) return state;
+      nRF24::clearIRQ();
+      state = _mod->SPIsetRegValue(RADIOLIB_NRF24_REG_CONFIG, RADIOLIB_NRF24_MASK_TX_DS_IRQ_ON, 5, 5);
+      if (state != RADIOLIB_ERR_NONE) return state;
+
+      nRF24::SPItransfer(RADIOLIB_NRF24_CMD_FLUSH_TX);
+      nRF24::SPIwriteTxPayload(data, len);
+      return RADIOLIB_ERR_NONE;
+    }
+
+    int16_t fireFrame() override {
+      // CE pulse (at least 10us) starts the transmission.
+      _mod->digitalWrite(_mod->getRst(), HIGH);
+      delayMicroseconds(10);
+      _mod->digitalWrite(_mod->getRst(), LOW);
+      return RADIOLIB_ERR_NONE;
+    }
+
+    uint32_t getTxSettleUs() override {
+      // Standby-I to TX settling (nRF24L01+ datasheet, Tstby2a).
+      return 130;
+    }
+
     virtual int16_t receiveMode() override {
       if (_mode != rfquack_Mode_RX) {
         // Set up receiving pipe.
@@ -50,6 +84,26 @@ public:
       }
     }
 
+    int16_t rearmReceive() override {
+      // readData() leaves CE high: the radio keeps listening while the payload is read.
+      // IRQ is edge triggered, if more payloads wait in the RX FIFO flag them right away.
+      disableReceivedFlag();
+      enableRxInterrupt();
+
+      uint8_t fifoStatus = _mod->SPIreadRegister(RADIOLIB_NRF24_REG_FIFO_STATUS);
+      if (!(fifoStatus & RADIOLIB_NRF24_RX_FIFO_EMPTY)) {
+        _receivedFlag.timestamp = esp_timer_get_time();
+        _receivedFlag.fired = true;
+      }
+
+      return RADIOLIB_ERR_NONE;
+    }
+
+    uint32_t getMinInterPacketGapUs() override {
+      // The radio never leaves RX while packets are read, the 3 level RX FIFO absorbs back-to-back packets.
+      return getRxSettleUs();
+    }
+
     int16_t readData(uint8_t *data, size_t len) override {
       // set mode to standby
       size_t length = 32;
@@ -116,6 +170,25 @@ public:
       return state;
     }
     
+    int16_t compileChannel(float freq, RFQChannel &channel) override {
+      auto mhz = (int16_t) freq;
+      if (mhz < 2400 || mhz > 2525) return RADIOLIB_ERR_INVALID_FREQUENCY;
+
+      channel.freq = freq;
+      channel.length = 1;
+      channel.image[0] = (uint8_t) (mhz - 2400);
+      return RADIOLIB_ERR_NONE;
+    }
+
+    int16_t writeChannel(const RFQChannel &channel) override {
+      // RF_CH is picked up going through Standby-I: drop CE, retune, bring it back up if receiving.
+      _mod->digitalWrite(_mod->getRst(), LOW);
+      _mod->SPIwriteRegister(RADIOLIB_NRF24_REG_RF_CH, channel.image[0]);
+      if (_mode == rfquack_Mode_RX) _mod->digitalWrite(_mod->getRst(), HIGH);
+      _freq = (int16_t) channel.freq;
+      return RADIOLIB_ERR_NONE;
+    }
+
     int16_t getModulation(char *modulation) override {
       // nRF24 supports only GFSK
       strcpy(modulation, "GFSK");
@@ -180,6 +253,55 @@ public:
       return _mod->SPIsetRegValue(RADIOLIB_NRF24_REG_DYNPD, RADIOLIB_NRF24_DPL_ALL_ON, 5, 0);
     }
 
+    int16_t captureProfile(RFQModemProfile &profile) override {
+      // Registers CONFIG to FEATURE, one at a time: the nRF24 has no burst register access.
+      profile.imageLength = RADIOLIB_NRF24_REG_FEATURE + 1;
+      for (uint8_t reg = 0; reg < profile.imageLength; reg++) {
+        if (isProfileRegister(reg)) profile.image[reg] = _mod->SPIreadRegister(reg);
+      }
+
+      profile.freq = _freq;
+      profile.bitRate = _dataRate;
+      profile.power = _power;
+      profile.crcOn = _mod->SPIgetRegValue(RADIOLIB_NRF24_REG_CONFIG, 3, 3) != 0;
+      profile.promiscuous = _promiscuous;
+      profile.syncWordLength = _addrWidth;
+      memcpy(profile.syncWords, _addr, sizeof(_addr));
+      return RADIOLIB_ERR_NONE;
+    }
+
+    int16_t restoreProfile(const RFQModemProfile &profile) override {
+      if (profile.imageLength != RADIOLIB_NRF24_REG_FEATURE + 1) return ERR_PROFILE_MISMATCH;
+
+      // Note: this command will bring radio back to standby mode.
+      rfquack_Mode previousMode = _mode;
+      int16_t state = nRF24::standby();
+      if (state != RADIOLIB_ERR_NONE) return state;
+      _mode = rfquack_Mode_IDLE;
+
+      for (uint8_t reg = 0; reg < profile.imageLength; reg++) {
+        if (!isProfileRegister(reg)) continue;
+        if (reg == RADIOLIB_NRF24_REG_CONFIG) {
+          // Keep power and RX / TX bits, they follow the mode.
+          _mod->SPIsetRegValue(reg, profile.image[reg], 7, 2);
+        } else {
+          _mod->SPIwriteRegister(reg, profile.image[reg]);
+        }
+      }
+
+      _freq = (int16_t) profile.freq;
+      _dataRate = (int16_t) profile.bitRate;
+      _power = profile.power;
+      _promiscuous = profile.promiscuous;
+      _addrWidth = profile.syncWordLength;
+      // Pipe addresses are set from it when entering RX / TX.
+      memcpy(_addr, profile.syncWords, sizeof(_addr));
+
+      // Back to RX, on the restored pipe address.
+      if (previousMode == rfquack_Mode_RX) return receiveMode();
+      return RADIOLIB_ERR_NONE;
+    }
+
     int16_t isCarrierDetected(bool *isDetected) override {
       // Value is correct 170uS after RX mode is issued
       *isDetected = nRF24::isCarrierDetected();
@@ -190,9 +312,11 @@ public:
       return nRF24::setAutoAck(autoAckOn);
     }
 
-    void
-    writeRegister(rfquack_register_address_t reg, rfquack_register_value_t value, uint8_t msb, uint8_t lsb) override {
-      _mod->SPIsetRegValue((uint8_t) reg, (uint8_t) value, msb, lsb);
+    bool isVolatileRegister(uint8_t reg) override {
+      // CONFIG is rewritten by every RX / TX / standby transition.
+      return reg == RADIOLIB_NRF24_REG_CONFIG || reg == RADIOLIB_NRF24_REG_STATUS ||
+             reg == RADIOLIB_NRF24_REG_OBSERVE_TX || reg == RADIOLIB_NRF24_REG_RPD ||
+             reg == RADIOLIB_NRF24_REG_FIFO_STATUS;
     }
 
     void removeInterrupts() override {
@@ -208,6 +332,22 @@ public:
       attachInterruptArg(digitalPinToInterrupt(_mod->getIrq()), func, (void *) (&_transmittedFlag), FALLING);
     }
 private:
+    // Registers restored by profiles: not status, not multi-byte (pipe addresses come from _addr), not reserved.
+    static bool isProfileRegister(uint8_t reg) {
+      switch (reg) {
+        case RADIOLIB_NRF24_REG_STATUS:
+        case RADIOLIB_NRF24_REG_OBSERVE_TX:
+        case RADIOLIB_NRF24_REG_RPD:
+        case RADIOLIB_NRF24_REG_RX_ADDR_P0:
+        case RADIOLIB_NRF24_REG_RX_ADDR_P1:
+        case RADIOLIB_NRF24_REG_TX_ADDR:
+        case RADIOLIB_NRF24_REG_FIFO_STATUS:
+          return false;
+        default:
+          return reg < RADIOLIB_NRF24_REG_FIFO_STATUS || reg >= RADIOLIB_NRF24_REG_DYNPD;
+      }
+    }
+
     // Config variables not provided by RadioLib, initialised with default values
     byte _addr[5] = {0x01, 0x23, 0x45, 0x67, 0x89}; // Cannot be > 5 bytes. Default len is 5.
     bool _promiscuous = false;
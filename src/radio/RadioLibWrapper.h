@@ -4,6 +4,16 @@
 // More error codes
 #define ERR_COMMAND_NOT_IMPLEMENTED -590
 #define ERR_WRONG_MODE -591
+#define ERR_RX_FIFO_OVERFLOW -592
+#define ERR_TX_QUEUE_FULL -593
+#define ERR_TX_BUSY -594
+#define ERR_NOTHING_STAGED -595
+#define ERR_PROFILE_NOT_FOUND -596
+#define ERR_PROFILE_MISMATCH -597
+#define ERR_NO_SUCH_CHANNEL -598
+#define ERR_INVALID_REGISTER -599
+#define ERR_INVALID_PROGRAM -600
+#define ERR_PROGRAM_TOO_LONG -601
 
 // Enable super powers :)
 #define RADIOLIB_LOW_LEVEL
@@ -16,9 +26,17 @@
 #define _RADIOLIB_MQTT_H
 
 #include <RadioLib.h>
-#include <cppQueue.h>
+#include <esp_timer.h>
 #include "../defaults/radio.h"
 #include "../modules/ModulesDispatcher.h"
+#include "RFQPacketPool.h"
+#include "RFQPacketRing.h"
+#include "RFQTxQueue.h"
+#include "RFQRegisterCache.h"
+#include "RFQRegisterImage.h"
+#include "RFQModemProfile.h"
+#include "RFQRadioSnapshot.h"
+#include "RFQChannelPlan.h"
 
 extern ModulesDispatcher modulesDispatcher;
 
@@ -27,29 +45,41 @@ typedef uint8_t rfquack_register_value_t;
 
 extern QueueHandle_t queue; // Queue of incoming packets
 
+/**
+ * Flag raised by radioInterrupt(), along with the time the interrupt fired.
+ */
+typedef struct RFQIrqFlag
+{
+  volatile bool fired = false;
+  volatile uint64_t timestamp = 0; // us since boot (esp_timer_get_time())
+  TaskHandle_t volatile task = NULL; // Task to notify when the flag is raised, if any.
+} RFQIrqFlag;
+
 class IRQ
 {
 public:
   /* RX flag */
-  void disableReceivedFlag(void) { _receivedFlag = false; }
+  void disableReceivedFlag(void) { _receivedFlag.fired = false; }
   void setReceivedFlag(void)
   {
     if (!_enableRxInterrupt)
     {
       return;
     }
-    _receivedFlag = true;
+    _receivedFlag.timestamp = esp_timer_get_time();
+    _receivedFlag.fired = true;
   }
 
   /* TX flag */
-  void disableTransmittedFlag(void) { _transmittedFlag = false; }
+  void disableTransmittedFlag(void) { _transmittedFlag.fired = false; }
   void setTransmittedFlag(void)
   {
     if (!_enableTxInterrupt)
     {
       return;
     }
-    _transmittedFlag = true;
+    _transmittedFlag.timestamp = esp_timer_get_time();
+    _transmittedFlag.fired = true;
   }
 
   /* IRQ enable */
@@ -61,14 +91,157 @@ public:
 protected:
   volatile bool _enableRxInterrupt = false;
   volatile bool _enableTxInterrupt = false;
-  volatile bool _receivedFlag = false;
-  volatile bool _transmittedFlag = false;
+  RFQIrqFlag _receivedFlag;
+  RFQIrqFlag _transmittedFlag;
   volatile bool _canTransmit = false;
 };
 
+/**
+ * Modem configuration stamped onto every received packet.
+ */
+typedef struct RFQModemShadow {
+  bool has_syncWords = false;
+  rfquack_Packet_syncWords_t syncWords;
+  bool has_bitRate = false;
+  float bitRate;
+  bool has_carrierFreq = false;
+  float carrierFreq;
+  bool has_frequencyDeviation = false;
+  float frequencyDeviation;
+  bool has_modulation = false;
+  char modulation[sizeof(rfquack_Packet::modulation)];
+} RFQModemShadow;
+
+/**
+ * Per radio RX statistics.
+ */
+typedef struct RFQRadioStats {
+  // Time spent out of RX for each packet, from IRQ detection to re-arm (us).
+  uint32_t rearmLatencyLastUs = 0;
+  uint32_t rearmLatencyMaxUs = 0;
+  uint32_t rearmLatencyAvgUs = 0;
+
+  // Minimum gap between two packets for both to be received (us), see getMinInterPacketGapUs().
+  uint32_t minInterPacketGapUs = 0;
+
+  // Packets read from the radio, lost (pool or RX queue full) and rejected by onPacketReceived() hooks.
+  uint32_t received = 0;
+  uint32_t dropped = 0;
+  uint32_t filtered = 0;
+
+  // Lateness of scheduled frames, from their due time to their start (us).
+  uint32_t txJitterLastUs = 0;
+  uint32_t txJitterMaxUs = 0;
+  uint32_t txJitterAvgUs = 0;
+
+  // Frames started, and frames started per second (measured over one second).
+  uint32_t txFrames = 0;
+  uint32_t txRate = 0;
+
+  // Time from fireStaged() to the chip transmitting (us).
+  uint32_t fireLatencyLastUs = 0;
+  uint32_t fireLatencyMaxUs = 0;
+
+  // SPI transactions issued by readRegister() / writeRegister(), reads served by the register
+  // cache and masked writes merged into a pending one.
+  uint32_t regSpiReads = 0;
+  uint32_t regSpiWrites = 0;
+  uint32_t regCacheHits = 0;
+  uint32_t regWritesMerged = 0;
+
+  // Channel plan hops, and time taken by each hop (us).
+  uint32_t hops = 0;
+  uint32_t hopLatencyLastUs = 0;
+  uint32_t hopLatencyMaxUs = 0;
+} RFQRadioStats;
+
+/**
+ * Per radio RX queue overflow policy (tunable at runtime).
+ */
+typedef struct RFQRxOverflow {
+  uint32_t policy = RFQUACK_RADIO_RX_OVERFLOW_POLICY; // rfquack_RxOverflowPolicy
+  uint32_t sampleEvery = RFQUACK_RADIO_RX_OVERFLOW_SAMPLE_EVERY; // SAMPLE: one packet kept every sampleEvery.
+  uint32_t overflowed = 0; // Packets found the queue full, drives SAMPLE.
+} RFQRxOverflow;
+
+/**
+ * Packet being read out of a radio FIFO, possibly over several rxLoop() calls.
+ */
+typedef struct RFQRxStream {
+  bool active = false;
+  rfquack_packet_handle_t handle = RFQUACK_PACKET_HANDLE_NONE; // NONE if the pool was exhausted: drained, then dropped.
+  uint64_t rxMicros = 0;
+  size_t length = 0; // Packet length.
+  size_t read = 0;   // Bytes read so far.
+} RFQRxStream;
+
 void IRAM_ATTR radioInterrupt(void *flag)
 {
-  *((bool *)(flag)) = true;
+  RFQIrqFlag *irq = (RFQIrqFlag *)(flag);
+  irq->timestamp = esp_timer_get_time();
+  irq->fired = true;
+
+  // Wake up the RX task (if any) straight from the ISR.
+  if (irq->task != NULL)
+  {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(irq->task, &woken);
+    if (woken == pdTRUE)
+      portYIELD_FROM_ISR();
+  }
+}
+
+/**
+ * Pushes a packet handle to the RX queue, applying the radio's overflow policy if it is full.
+ * Handles that don't end up in the queue (the packet's or an evicted one) are released.
+ *
+ * @return false if a packet was lost.
+ */
+bool enqueueRxPacket(rfquack_packet_handle_t handle, RFQPacketRing *rxQueue, RFQRxOverflow &overflow,
+                     RFQRadioStats &stats)
+{
+  rfquack_packet_handle_t evicted = RFQUACK_PACKET_HANDLE_NONE;
+  bool pushed = false;
+
+  // Each radio is the only producer of its RX queue, no lock needed.
+  switch (overflow.policy)
+  {
+  case rfquack_RxOverflowPolicy_DROP_OLDEST:
+    rxQueue->pushEvictingOldest(&handle, &evicted);
+    pushed = true;
+    break;
+  case rfquack_RxOverflowPolicy_SAMPLE:
+    if (!rxQueue->isFull())
+    {
+      pushed = rxQueue->push(&handle);
+    }
+    else if (overflow.sampleEvery > 0 && ++overflow.overflowed % overflow.sampleEvery == 0)
+    {
+      rxQueue->pushEvictingOldest(&handle, &evicted);
+      pushed = true;
+    }
+    break;
+  default:
+    pushed = rxQueue->push(&handle);
+  }
+
+  if (!pushed)
+  {
+    packetPool.release(handle);
+  }
+  if (evicted != RFQUACK_PACKET_HANDLE_NONE)
+  {
+    packetPool.release(evicted);
+  }
+
+  if (!pushed || evicted != RFQUACK_PACKET_HANDLE_NONE)
+  {
+    stats.dropped++;
+    RFQUACK_LOG_TRACE(F("rxQueue is full, packet dropped"));
+    return false;
+  }
+
+  return true;
 }
 
 template <typename T>
@@ -82,6 +255,9 @@ public:
   {
     this->chipName = new char[strlen(chipName) + 1];
     strcpy(this->chipName, chipName);
+#ifdef RFQUACK_RADIO_THREADED
+    _lock = xSemaphoreCreateRecursiveMutex();
+#endif
   }
 
   virtual int16_t begin()
@@ -97,6 +273,7 @@ public:
   void setWhichRadio(rfquack_WhichRadio whichRadio)
   {
     _whichRadio = whichRadio;
+    packetPool.reserve(whichRadio);
   }
 
   /**
@@ -134,6 +311,45 @@ public:
 
     if (state != RADIOLIB_ERR_NONE)
       return state;
+
+    return RADIOLIB_ERR_NONE;
+  }
+
+  /**
+   * Puts radio back in receive mode right after a packet was read.
+   * Unlike receiveMode() this does not re-register the interrupt routine,
+   * drivers override it with the cheapest way to get the chip listening again.
+   *
+   * @return \ref status_codes
+   */
+  virtual int16_t rearmReceive()
+  {
+    disableReceivedFlag();
+    enableRxInterrupt();
+
+    return T::startReceive();
+  }
+
+  /**
+   * Time the chip needs, after being re-armed, before it can detect a new packet.
+   *
+   * @return settle time in us.
+   */
+  virtual uint32_t getRxSettleUs()
+  {
+    return 0;
+  }
+
+  /**
+   * Minimum gap between the end of a packet and the start of the next one for the latter to be received:
+   * measured time spent out of RX while serving a packet plus the chip settle time.
+   * Drivers that keep the chip in RX while the packet is read override this.
+   *
+   * @return gap in us.
+   */
+  virtual uint32_t getMinInterPacketGapUs()
+  {
+    return _stats.rearmLatencyAvgUs + getRxSettleUs();
   }
 
   /**
@@ -177,19 +393,33 @@ public:
   {
     RFQUACK_LOG_TRACE(F("setMode <- %d"), mode);
 
+    // A staged frame doesn't survive a mode change.
+    _staged = false;
+
+    // Pending register writes take effect before the mode change, which may rewrite registers.
+    flushRegisters();
+
+    int16_t state;
     switch (mode)
     {
     case rfquack_Mode_IDLE:
-      return standbyMode();
+      state = standbyMode();
+      break;
     case rfquack_Mode_RX:
-      return receiveMode();
+      state = receiveMode();
+      break;
     case rfquack_Mode_TX:
-      return transmitMode();
+      state = transmitMode();
+      break;
     case rfquack_Mode_JAM:
-      return jamMode();
+      state = jamMode();
+      break;
     default:
-      return RADIOLIB_ERR_UNKNOWN;
+      state = RADIOLIB_ERR_UNKNOWN;
     }
+
+    invalidateRegisterCache();
+    return state;
   }
 
   /**
@@ -203,12 +433,12 @@ public:
   }
 
   /**
-   * Sends packet to air.
+   * Starts sending a packet to air, without waiting: completion is handled by txLoop().
    *
    * @param data buffer to send
    * @param len buffer length
    *
-   * @return \ref status_codes
+   * @return \ref status_codes (\ref ERR_TX_BUSY if a transmission is still in progress)
    */
   virtual int16_t transmit(uint8_t *data, size_t len)
   {
@@ -220,26 +450,17 @@ public:
       return ERR_WRONG_MODE;
     }
 
-    RFQUACK_LOG_TRACE(F("Request to transmit, checking if channel is free."))
-    uint32_t start = micros();
-
-    // Wait for TX channel to be free (or timeout)
-    while (!isTxChannelFree())
+    if (!isTxChannelFree())
     {
-      // Check if timeout has reached.
-      if (micros() - start >= 60000)
-      {
-        T::standby();
-
-        RFQUACK_LOG_TRACE(F("We have been waiting too long for channel to get free."))
-        break;
-      }
-
-      delay(2);
+      return ERR_TX_BUSY;
     }
 
     RFQUACK_LOG_TRACE(F("Channel is free, go ahead transmitting"))
 
+    // Pending register writes apply to this frame, RadioLib rewrites some registers.
+    flushRegisters();
+    invalidateRegisterCache();
+
     // mark TX as busy
     _canTransmit = false;
 
@@ -262,17 +483,132 @@ public:
   {
     return (
         !_enableTxInterrupt // not waiting to finish TX
+        && !_staged         // TX FIFO not holding a staged frame
     );
   }
 
   /**
-   * Transmit an RFQuack Packet.
+   * Whether the transmission that just completed went fine (e.g. it was acknowledged).
+   * Called by txLoop() before finishing the transmission.
+   */
+  virtual bool isTransmitSuccessful()
+  {
+    return true;
+  }
+
+  /**
+   * Uploads a frame to the chip, ready to be sent by fireStaged() with the shortest possible delay.
+   * The chip is left in its fastest TX-ready state; the TX queue waits until the frame is fired
+   * or the mode changes.
+   *
+   * @param data buffer to send
+   * @param len buffer length
+   *
+   * @return \ref status_codes
+   */
+  int16_t stageTransmit(uint8_t *data, size_t len)
+  {
+    if (_mode != rfquack_Mode_TX)
+    {
+      RFQUACK_LOG_TRACE(F("In order to transmit you must be in TX mode."))
+      return ERR_WRONG_MODE;
+    }
+
+    if (!isTxChannelFree())
+    {
+      return ERR_TX_BUSY;
+    }
+
+    // Interrupt routine is registered now, it's not on the way when firing.
+    setTxInterruptAction(radioInterrupt);
+
+    flushRegisters();
+    invalidateRegisterCache();
+
+    int16_t state = stageFrame(data, len);
+    if (state != RADIOLIB_ERR_NONE)
+      return state;
+
+    _staged = true;
+    return RADIOLIB_ERR_NONE;
+  }
+
+  /**
+   * Sends the frame uploaded by stageTransmit(), measuring the time it takes for the chip to transmit.
+   *
+   * @return \ref status_codes
+   */
+  int16_t fireStaged()
+  {
+    if (!_staged || _mode != rfquack_Mode_TX)
+    {
+      return ERR_NOTHING_STAGED;
+    }
+
+    _canTransmit = false;
+    disableTransmittedFlag();
+    enableTxInterrupt();
+
+    uint64_t fireStart = esp_timer_get_time();
+    int16_t state = fireFrame();
+    uint32_t latencyUs = (uint32_t)(esp_timer_get_time() - fireStart) + getTxSettleUs();
+    _staged = false;
+
+    if (state != RADIOLIB_ERR_NONE)
+    {
+      disableTxInterrupt();
+      _canTransmit = true;
+      return state;
+    }
+
+    _stats.fireLatencyLastUs = latencyUs;
+    if (latencyUs > _stats.fireLatencyMaxUs)
+      _stats.fireLatencyMaxUs = latencyUs;
+    RFQUACK_LOG_TRACE(F("Staged frame fired in %dus"), latencyUs)
+    return RADIOLIB_ERR_NONE;
+  }
+
+  /**
+   * Uploads a frame to the chip FIFO without sending it, see stageTransmit().
+   *
+   * @return \ref status_codes
+   */
+  virtual int16_t stageFrame(uint8_t *data, size_t len)
+  {
+    return ERR_COMMAND_NOT_IMPLEMENTED;
+  }
+
+  /**
+   * Starts sending the staged frame (e.g. a strobe or a CE pulse); returns once the chip
+   * is transmitting, or as soon as possible for chips that can't tell (see getTxSettleUs()).
+   *
+   * @return \ref status_codes
+   */
+  virtual int16_t fireFrame()
+  {
+    return ERR_COMMAND_NOT_IMPLEMENTED;
+  }
+
+  /**
+   * Time the chip needs, after fireFrame() returns, to be on air. Added to the fire latency.
+   *
+   * @return settle time in us.
+   */
+  virtual uint32_t getTxSettleUs()
+  {
+    return 0;
+  }
+
+  /**
+   * Queues an RFQuack Packet for transmission, repeated pkt->repeat times.
+   * Returns immediately: frames are sent by txLoop(), the outcome is reported by popTxReport().
    *
    * @param pkt packet to transmit
+   * @param[out] jobId id of the transmission job, may be nullptr.
    *
    * @return \ref status_codes
    */
-  uint8_t transmit(rfquack_Packet *pkt)
+  int16_t transmit(rfquack_Packet *pkt, uint32_t *jobId = nullptr)
   {
     if (pkt->has_repeat && pkt->repeat == 0)
     {
@@ -280,29 +616,44 @@ public:
       return RADIOLIB_ERR_NONE;
     }
 
-    uint32_t repeat = 1;
-    uint32_t correct = 0;
-
-    if (pkt->has_repeat)
+    // Exit if radio is not in TX mode.
+    if (_mode != rfquack_Mode_TX)
     {
-      repeat = pkt->repeat;
+      RFQUACK_LOG_TRACE(F("In order to transmit you must be in TX mode."))
+
+      return ERR_WRONG_MODE;
     }
 
-    for (uint32_t i = 0; i < repeat; i++)
-    {
-      int16_t result = transmit((uint8_t *)(pkt->data.bytes), pkt->data.size);
-      RFQUACK_LOG_TRACE(F("Packet trasmitted, resultCode=%d"), result)
+    return _txQueue.enqueue(pkt, jobId);
+  }
 
-      if (result == RADIOLIB_ERR_NONE)
-      {
-        correct++;
-      }
-    }
+  /**
+   * Takes the report of a completed transmission job.
+   *
+   * @return false if there's none.
+   */
+  bool popTxReport(rfquack_TxReport *report)
+  {
+    return _txQueue.popReport(report);
+  }
 
-    RFQUACK_LOG_TRACE(F("%d packets transmitted"), correct)
-    if (correct > 0)
-      return RADIOLIB_ERR_NONE;
-    return RADIOLIB_ERR_UNKNOWN;
+  /**
+   * Whether the main loop has nothing to do for this radio: no frame to send and,
+   * unless another task reads it, not receiving.
+   */
+  bool isIdle()
+  {
+    if (_txQueue.front() != nullptr || _transmittedFlag.fired)
+      return false;
+#if defined(RFQUACK_RADIO_PIPELINE)
+    return true;
+#else
+#ifdef RFQUACK_RADIO_RX_TASKS
+    if (hasRxTask())
+      return true;
+#endif
+    return _mode != rfquack_Mode_RX;
+#endif
   }
 
   /**
@@ -318,7 +669,17 @@ public:
       return false;
     }
 
-    return _receivedFlag;
+    return _receivedFlag.fired;
+  }
+
+  /**
+   * Gets the length of the packet being received, to be read with readData().
+   *
+   * @return size_t packet length in bytes.
+   */
+  virtual size_t getRxPacketLength()
+  {
+    return getPacketLength(true);
   }
 
   /**
@@ -344,122 +705,450 @@ public:
   }
 
   /**
-   * Main transmit loop; check whether there's data being transmitted and clears IRQs.
+   * Reads the next bytes of the packet being received, as many as the radio holds.
+   * By default the whole packet is read at once.
+   *
+   * @param[out] data pointer to memory area to write data to.
+   * @param len bytes of the packet still to be read.
+   * @param[out] read bytes actually read, the rest is read on next calls.
+   *
+   * @return \ref status_codes
+   */
+  virtual int16_t readDataChunk(uint8_t *data, size_t len, size_t *read)
+  {
+    *read = len;
+    return readData(data, len);
+  }
+
+  /**
+   * Main transmit loop; clears IRQs once a frame is sent, then starts the next frame of the TX queue.
+   * A frame not sent within RFQUACK_RADIO_TX_TIMEOUT_US (channel busy or no completion IRQ) counts as failed.
+   *
+   * Scheduled frames are started when due: once the due time is less than RFQUACK_RADIO_TX_SPIN_US away,
+   * the loop waits for it here, so the start time doesn't depend on how long the rest of the loop takes.
+   */
+  void txLoop()
+  {
+    RFQTxJob *job = _txQueue.front();
+
+    if (_transmittedFlag.fired)
+    {
+      bool success = isTransmitSuccessful();
+
+      // disable the interrupt service routine while
+      // processing the data
+      disableTxInterrupt();
+
+      // reset TX flag
+      disableTransmittedFlag();
+
+      // clean up after transmission is finished
+      // this will ensure transmitter is disabled,
+      // RF switch is powered down etc.
+      T::finishTransmit();
+      _canTransmit = true;
+
+      if (_txInFlight && job != nullptr)
+      {
+        _txInFlight = false;
+        job->remaining--;
+        if (success)
+          job->sent++;
+        else
+          job->failed++;
+      }
+    }
+    else if ((_txInFlight || _txWaiting) && job != nullptr && micros() - _txFrameStart >= RFQUACK_RADIO_TX_TIMEOUT_US)
+    {
+      RFQUACK_LOG_TRACE(F("We have been waiting too long to transmit."))
+      if (_txInFlight)
+      {
+        T::standby();
+        disableTxInterrupt();
+        _canTransmit = true;
+      }
+      _txInFlight = false;
+      _txWaiting = false;
+      job->remaining--;
+      job->failed++;
+      RFQTxQueue::advance(job, esp_timer_get_time());
+    }
+
+    if (job == nullptr || _txInFlight)
+      return;
+
+    if (job->remaining == 0 || _mode != rfquack_Mode_TX)
+    {
+      // Frames left behind by a mode change are failed.
+      job->failed += job->remaining;
+      job->remaining = 0;
+      RFQUACK_LOG_TRACE(F("TX job %d done, %d sent, %d failed"), job->id, job->sent, job->failed)
+      _txQueue.complete();
+      return;
+    }
+
+    if (job->dueUs != 0 && !_txWaiting)
+    {
+      uint64_t now = esp_timer_get_time();
+      if (job->dueUs > now)
+      {
+        if (job->dueUs - now > RFQUACK_RADIO_TX_SPIN_US)
+          return;
+
+        // Close enough, wait for it.
+        while (esp_timer_get_time() < job->dueUs)
+        {
+        }
+      }
+    }
+
+    rfquack_Packet *pkt = _txQueue.packetOf(job);
+    uint64_t startUs = esp_timer_get_time();
+    int16_t result = transmit((uint8_t *)(pkt->data.bytes), pkt->data.size);
+    if (result == ERR_TX_BUSY)
+    {
+      // Channel still busy, wait for it (up to the timeout) without blocking.
+      if (!_txWaiting)
+      {
+        _txWaiting = true;
+        _txFrameStart = micros();
+      }
+      return;
+    }
+
+    _txWaiting = false;
+    if (result == RADIOLIB_ERR_NONE)
+    {
+      _txInFlight = true;
+      _txFrameStart = micros();
+      updateTxStats(job, startUs);
+    }
+    else
+    {
+      RFQUACK_LOG_TRACE(F("Packet not transmitted, resultCode=%d"), result)
+      job->remaining--;
+      job->failed++;
+    }
+    RFQTxQueue::advance(job, startUs);
+  }
+
+  /**
+   * Main receive loop; reads any data from the RX FIFO into a packet pool slot and
+   * pushes its handle to the RX queue.
+   *
+   * Packets longer than the radio FIFO are read over several calls, as their bytes come in
+   * (see readDataChunk()): the handle is pushed once the whole packet is read.
+   *
+   * @param[out] rxQueue pointer to queue of packet handles to write received data to.
+   */
+  void rxLoop(RFQPacketRing *rxQueue)
+  {
+    if (_rxStream.active)
+    {
+      readPacket(rxQueue);
+      return;
+    }
+
+    // only if we're waiting to receive something (faster polling loop)
+    if (_enableRxInterrupt)
+    {
+      // Check if there's pending data on radio's RX FIFO.
+      if (isIncomingDataAvailable())
+      {
+        // Capture time as seen by the ISR. Drivers polling the IRQ line may get here
+        // without the ISR having fired (e.g. back-to-back packets): fall back to now.
+        _rxStream.rxMicros = _receivedFlag.fired ? _receivedFlag.timestamp : esp_timer_get_time();
+
+        // disable the interrupt service routine while
+        // processing the data
+        disableRxInterrupt();
+
+        // reset RX flag
+        disableReceivedFlag();
+
+        // Fill a pool slot in place, only its handle will be queued.
+        // If the pool is exhausted the packet is still drained from the FIFO, then dropped.
+        _stats.received++;
+        _rxStream.handle = packetPool.acquire(_whichRadio);
+        _rxStream.length = min(getRxPacketLength(), sizeof(rfquack_Packet().data.bytes));
+        _rxStream.read = 0;
+        _rxStream.active = true;
+        readPacket(rxQueue);
+      }
+    }
+  }
+
+  /**
+   * @return true while a packet is read over several rxLoop() calls.
+   */
+  bool isReceivingPacket()
+  {
+    return _rxStream.active;
+  }
+
+  /**
+   * Marks the modem configuration shadow as stale: next syncModemShadow() re-reads it.
+   * Must be called whenever the modem configuration may change (setters, register writes).
+   */
+  void invalidateModemShadow()
+  {
+    _shadowValid = false;
+  }
+
+  /**
+   * Refreshes the modem configuration shadow from the driver getters, if stale.
+   * Called from the main loop, outside of the RX path.
+   */
+  void syncModemShadow()
+  {
+    if (_shadowValid)
+      return;
+
+    _shadow.has_syncWords = (getSyncWord(_shadow.syncWords.bytes, &(_shadow.syncWords.size))) == RADIOLIB_ERR_NONE;
+    _shadow.has_bitRate = (getBitRate(&(_shadow.bitRate))) == RADIOLIB_ERR_NONE;
+    _shadow.has_carrierFreq = (getFrequency(&(_shadow.carrierFreq))) == RADIOLIB_ERR_NONE;
+    _shadow.has_frequencyDeviation = (getFrequencyDeviation(&(_shadow.frequencyDeviation))) == RADIOLIB_ERR_NONE;
+    _shadow.has_modulation = getModulation(_shadow.modulation) == RADIOLIB_ERR_NONE;
+    _shadowValid = true;
+  }
+
+  /**
+   * @brief Get RX statistics of this radio.
+   */
+  RFQRadioStats *getStats()
+  {
+    return &_stats;
+  }
+
+  /**
+   * @brief Get the RX queue overflow policy of this radio.
+   */
+  RFQRxOverflow *getRxOverflow()
+  {
+    return &_rxOverflow;
+  }
+
+#ifdef RFQUACK_RADIO_THREADED
+  /**
+   * Takes exclusive access to the radio (and its SPI transactions).
+   * Recursive: hooks running in the RX task may issue radio commands.
+   */
+  void lock()
+  {
+    xSemaphoreTakeRecursive(_lock, portMAX_DELAY);
+  }
+
+  void unlock()
+  {
+    xSemaphoreGiveRecursive(_lock);
+  }
+#endif
+
+#ifdef RFQUACK_RADIO_PIPELINE
+  /**
+   * Sets the task notified by radioInterrupt() when a packet is received.
+   */
+  void setRxNotifyTask(TaskHandle_t task)
+  {
+    _receivedFlag.task = task;
+  }
+#endif
+
+#ifdef RFQUACK_RADIO_RX_TASKS
+
+  /**
+   * Spawns the RX task of this radio: it sleeps until radioInterrupt() notifies it,
+   * then reads the RX FIFO and pushes packet handles to rxQueue.
+   *
+   * @param rxQueue queue of packet handles to write received data to.
+   */
+  void startRxTask(RFQPacketRing *rxQueue)
+  {
+    if (_rxTask != NULL)
+      return;
+
+    _rxTaskQueue = rxQueue;
+    xTaskCreateUniversal(rxTaskEntry, getChipName(), RFQUACK_RADIO_RX_TASK_STACK, this,
+                         RFQUACK_RADIO_RX_TASK_PRIORITY, (TaskHandle_t *)&_rxTask, RFQUACK_RADIO_RX_TASK_CORE);
+    _receivedFlag.task = _rxTask;
+  }
+
+  /**
+   * @return true if packets are read by the RX task rather than by rxLoop() callers.
+   */
+  bool hasRxTask()
+  {
+    return _rxTask != NULL;
+  }
+#endif
+
+  /**
+   * Reads a radio's internal register, from the register cache if its content is known.
+   * A pending write to the register is flushed first.
+   *
+   * @param reg address of register to read from.
+   *
+   * @return rfquack_register_value_t content read from the register.
+   */
+  rfquack_register_value_t readRegister(rfquack_register_address_t reg)
+  {
+    uint8_t address = (uint8_t)reg;
+    if (_regCache.isPending(address))
+      flushRegister(address);
+
+    uint8_t value;
+    if (!isVolatileRegister(address) && _regCache.get(address, &value))
+    {
+      _stats.regCacheHits++;
+      return value;
+    }
+
+    value = spiReadRegister(address);
+    _stats.regSpiReads++;
+    if (!isVolatileRegister(address))
+      _regCache.set(address, value);
+    return value;
+  }
+
+  /**
+   * Writes to a radio's internal register.
+   * The write is held back, merged with the following ones to the same register, until
+   * flushRegisters() is called: explicitly, on mode change, before setters and TX, or by the main loop.
+   *
+   * @param reg register address to write to.
+   * @param value value to write, already positioned between msb and lsb.
+   *
+   * @param msb Most significant bit of the register variable. Bits above this one will be masked out.
+   * @param lsb Least significant bit of the register variable. Bits below this one will be masked out.
+   */
+  void writeRegister(rfquack_register_address_t reg, rfquack_register_value_t value, uint8_t msb = 7, uint8_t lsb = 0)
+  {
+    uint8_t address = (uint8_t)reg;
+    uint8_t mask = (uint8_t)((0xFF >> (7 - msb)) & (0xFF << lsb));
+
+    if (!RFQRegisterCache::isCacheable(address) || isVolatileRegister(address))
+    {
+      // Written straight away.
+      uint8_t current = mask == 0xFF ? 0 : spiReadRegister(address);
+      if (mask != 0xFF)
+        _stats.regSpiReads++;
+      spiWriteRegister(address, (current & ~mask) | ((uint8_t)value & mask));
+      _stats.regSpiWrites++;
+      return;
+    }
+
+    if (_regCache.stage(address, (uint8_t)value, mask))
+      _stats.regWritesMerged++;
+  }
+
+  /**
+   * Sends pending register writes to the chip, one SPI write per register
+   * (plus a read for partial writes to registers not in the cache).
+   */
+  void flushRegisters()
+  {
+    while (_regCache.getPendingCount() > 0)
+      flushRegister(_regCache.getPending(0));
+  }
+
+  /**
+   * Reads consecutive registers with as few SPI transactions as the chip allows (one burst on most).
+   * Pending writes are flushed first; values read fill the register cache.
+   *
+   * @param first address of the first register.
+   * @param len number of registers.
+   * @param values filled with len values.
+   *
+   * @return \ref status_codes (\ref ERR_NONE or \ref ERR_INVALID_REGISTER)
    */
-  void txLoop()
+  int16_t readRegisterBlock(uint8_t first, uint8_t len, uint8_t *values)
   {
-    if (_transmittedFlag)
-    {
-      // disable the interrupt service routine while
-      // processing the data
-      disableTxInterrupt();
+    if (len == 0 || first + len > 0x100)
+      return ERR_INVALID_REGISTER;
+    flushRegisters();
 
-      // reset TX flag
-      disableTransmittedFlag();
+    int16_t state = spiReadRegisterBurst(first, len, values);
+    if (state != RADIOLIB_ERR_NONE)
+      return state;
+    _stats.regSpiReads++;
 
-      // clean up after transmission is finished
-      // this will ensure transmitter is disabled,
-      // RF switch is powered down etc.
-      T::finishTransmit();
-      _canTransmit = true;
+    for (uint8_t i = 0; i < len; i++)
+    {
+      uint8_t address = first + i;
+      if (!isVolatileRegister(address))
+        _regCache.set(address, values[i]);
     }
+    return RADIOLIB_ERR_NONE;
   }
 
   /**
-   * Main receive loop; reads any data from the RX FIFO and push it to the RX queue.
+   * Writes consecutive registers with as few SPI transactions as the chip allows.
+   * Pending writes are flushed first, so these values win.
    *
-   * @param[out] rxQueue pointer to queue to write received data to.
+   * @return \ref status_codes (\ref ERR_NONE or \ref ERR_INVALID_REGISTER if the range can't be written)
    */
-  void rxLoop(Queue *rxQueue)
+  int16_t writeRegisterBlock(uint8_t first, uint8_t len, const uint8_t *values)
   {
-    // only if we're waiting to receive something (faster polling loop)
-    if (_enableRxInterrupt)
-    {
-      // Check if there's pending data on radio's RX FIFO.
-      if (isIncomingDataAvailable())
-      {
-        // disable the interrupt service routine while
-        // processing the data
-        disableRxInterrupt();
-
-        // reset RX flag
-        disableReceivedFlag();
-
-        rfquack_Packet pkt = rfquack_Packet_init_zero;
-
-        // Pop packet from RX FIFO.
-        uint8_t packetLen = getPacketLength(true);
-        uint64_t startReceive = millis();
-        int16_t result = readData((uint8_t *)pkt.data.bytes, packetLen);
+    if (len == 0 || first + len > 0x100)
+      return ERR_INVALID_REGISTER;
+    flushRegisters();
 
-        if (result != RADIOLIB_ERR_NONE)
-        {
-          RFQUACK_LOG_ERROR(F("Error while reading data from driver, code=%d"), result);
-        }
-
-        RFQUACK_LOG_TRACE(F("Putting radio back in RX"));
-
-        // Put radio back in receiveMode.
-        receiveMode();
-
-        // Fill missing data
-        pkt.data.size = packetLen;
-        pkt.millis = startReceive;
-        pkt.has_millis = true;
-        pkt.rxRadio = this->_whichRadio;
-        pkt.has_rxRadio = true;
-        strcpy(pkt.model, getChipName());
-        pkt.has_model = true;
-
-        // Set the syncWords
-        pkt.has_syncWords = (getSyncWord(pkt.syncWords.bytes, &(pkt.syncWords.size))) == RADIOLIB_ERR_NONE;
-
-        // Set the bitrate
-        pkt.has_bitRate = (getBitRate(&(pkt.bitRate))) == RADIOLIB_ERR_NONE;
-
-        // Set the carrierFreq
-        pkt.has_carrierFreq = (getFrequency(&(pkt.carrierFreq))) == RADIOLIB_ERR_NONE;
-
-        pkt.has_frequencyDeviation = (getFrequencyDeviation(&(pkt.frequencyDeviation))) == RADIOLIB_ERR_NONE; // Set the frequency deviation
+    int16_t state = spiWriteRegisterBurst(first, len, values);
+    if (state != RADIOLIB_ERR_NONE)
+      return state;
+    _stats.regSpiWrites++;
 
-        pkt.has_modulation = getModulation(pkt.modulation) == RADIOLIB_ERR_NONE; // Set the modulation
+    _regCache.invalidate();
+    return RADIOLIB_ERR_NONE;
+  }
 
-        pkt.has_RSSI = (getRSSI(&(pkt.RSSI))) == RADIOLIB_ERR_NONE; // Set the RSSI
+  /**
+   * Forgets the register cache; to be called whenever registers may be written by other means (e.g. RadioLib setters).
+   */
+  void invalidateRegisterCache()
+  {
+    _regCache.invalidate();
+  }
 
-        // onPacketReceived() hook
-        if (modulesDispatcher.onPacketReceived(pkt, _whichRadio))
-        {
-          // If packet passed filtering put it in rxQueue.
-          enqueuePacket(&pkt, rxQueue);
-        }
-      }
-    }
+  /**
+   * Registers whose content changes by itself (status, FIFO, calibration) or
+   * is rewritten by RX/TX: never cached.
+   */
+  virtual bool isVolatileRegister(uint8_t reg)
+  {
+    return false;
   }
 
   /**
-   * Reads a radio's internal register.
-   *
-   * @param reg address of register to read from.
-   *
-   * @return rfquack_register_value_t content read from the register.
+   * Single register read / write SPI transactions, used by the register cache.
    */
-  virtual rfquack_register_value_t readRegister(rfquack_register_address_t reg)
+  virtual uint8_t spiReadRegister(uint8_t reg)
   {
-    return T::_mod->SPIreadRegister((uint8_t)reg);
+    return T::_mod->SPIreadRegister(reg);
+  }
+
+  virtual void spiWriteRegister(uint8_t reg, uint8_t value)
+  {
+    T::_mod->SPIwriteRegister(reg, value);
   }
 
   /**
-   * Writes to a radio's internal register.
-   *
-   * @param reg register address to write to.
-   * @param value value to write.
-   *
-   * @param msb Most significant bit of the register variable. Bits above this one will be masked out.
-   * @param lsb Least significant bit of the register variable. Bits below this one will be masked out.
-   *
-   * @returns Masked register value or status code.
+   * Multi register read / write, used by readRegisterBlock() and writeRegisterBlock().
+   * Defaults to one transaction per register, for chips without burst access.
    */
-  virtual void writeRegister(rfquack_register_address_t reg, rfquack_register_value_t value, uint8_t msb = 7, uint8_t lsb = 0) = 0;
+  virtual int16_t spiReadRegisterBurst(uint8_t first, uint8_t len, uint8_t *values)
+  {
+    for (uint8_t i = 0; i < len; i++)
+      values[i] = spiReadRegister(first + i);
+    return RADIOLIB_ERR_NONE;
+  }
+
+  virtual int16_t spiWriteRegisterBurst(uint8_t first, uint8_t len, const uint8_t *values)
+  {
+    for (uint8_t i = 0; i < len; i++)
+      spiWriteRegister(first + i, values[i]);
+    return RADIOLIB_ERR_NONE;
+  }
 
   /**
    * Sets transmitted / received preamble length.
@@ -658,7 +1347,22 @@ public:
   }
 
   /**
-   * Puts radio in fixed packet length mode.
+   * Puts radio in infinite packet length mode: once a sync word is detected,
+   * captureLen bytes are received whatever the packet format.
+   *
+   * @param captureLen Bytes captured after each sync word.
+   *
+   * @return \ref status_codes (\ref ERR_NONE or \ref ERR_COMMAND_NOT_IMPLEMENTED)
+   */
+  virtual int16_t infinitePacketLengthMode(uint8_t captureLen)
+  {
+    RFQUACK_LOG_ERROR(F("infinitePacketLengthMode was not implemented."));
+
+    return ERR_COMMAND_NOT_IMPLEMENTED;
+  }
+
+  /**
+   * Puts radio in variable packet length mode.
    *
    * @param len Maximum packet size in bytes.
    *
@@ -699,6 +1403,186 @@ public:
     return ERR_COMMAND_NOT_IMPLEMENTED;
   }
 
+  /**
+   * Applies every field set in a modem configuration at once.
+   * Drivers compile the whole configuration into a register image, validate all of it before
+   * touching the chip, then write it with a single burst: either everything is applied or nothing.
+   *
+   * @param cfg modem configuration, only the has_* fields are applied.
+   *
+   * @return \ref status_codes (\ref ERR_NONE or \ref ERR_COMMAND_NOT_IMPLEMENTED if the caller
+   * must fall back to the single setters)
+   */
+  virtual int16_t applyModemConfig(rfquack_ModemConfig &cfg)
+  {
+    return ERR_COMMAND_NOT_IMPLEMENTED;
+  }
+
+  /**
+   * Captures the current configuration (register image and driver state) in a profile.
+   *
+   * @return \ref status_codes (\ref ERR_NONE or \ref ERR_COMMAND_NOT_IMPLEMENTED)
+   */
+  int16_t saveProfile(RFQModemProfile &profile)
+  {
+    memset(&profile, 0, sizeof(profile));
+    profile.version = RFQModemProfile::VERSION;
+    strncpy(profile.chipName, chipName, sizeof(profile.chipName) - 1);
+    return captureProfile(profile);
+  }
+
+  /**
+   * Restores a profile captured by saveProfile(): the register image is written as is,
+   * nothing is recomputed.
+   *
+   * @return \ref status_codes (\ref ERR_NONE, \ref ERR_PROFILE_MISMATCH if captured from another
+   * kind of radio, or \ref ERR_COMMAND_NOT_IMPLEMENTED)
+   */
+  int16_t loadProfile(const RFQModemProfile &profile)
+  {
+    if (profile.version != RFQModemProfile::VERSION ||
+        strncmp(profile.chipName, chipName, sizeof(profile.chipName) - 1) != 0)
+    {
+      RFQUACK_LOG_ERROR(F("Profile was captured from a %s radio"), profile.chipName)
+      return ERR_PROFILE_MISMATCH;
+    }
+    return restoreProfile(profile);
+  }
+
+  /**
+   * Captures the radio's registers and mode, so that whoever borrows the radio can hand it back
+   * with restoreSnapshot(). Registers are read in bursts where the chip allows it.
+   *
+   * @return \ref status_codes (\ref ERR_NONE or \ref ERR_COMMAND_NOT_IMPLEMENTED)
+   */
+  int16_t takeSnapshot(RFQRadioSnapshot &snapshot)
+  {
+    snapshot.mode = _mode;
+    int16_t state = saveProfile(snapshot.profile);
+    snapshot.taken = state == RADIOLIB_ERR_NONE;
+    return state;
+  }
+
+  /**
+   * Writes back the registers of a snapshot taken by takeSnapshot() and puts the radio back in
+   * the mode it was in. The snapshot can't be restored twice.
+   *
+   * @return \ref status_codes
+   */
+  int16_t restoreSnapshot(RFQRadioSnapshot &snapshot)
+  {
+    if (!snapshot.taken)
+      return ERR_PROFILE_NOT_FOUND;
+    snapshot.taken = false;
+
+    int16_t state = loadProfile(snapshot.profile);
+    if (state == RADIOLIB_ERR_NONE && _mode != snapshot.mode)
+      state = setMode(snapshot.mode);
+    return state;
+  }
+
+  // Fills the register image and driver state of a profile.
+  virtual int16_t captureProfile(RFQModemProfile &profile)
+  {
+    return ERR_COMMAND_NOT_IMPLEMENTED;
+  }
+
+  // Writes back the register image of a profile and restores the driver state.
+  virtual int16_t restoreProfile(const RFQModemProfile &profile)
+  {
+    return ERR_COMMAND_NOT_IMPLEMENTED;
+  }
+
+  /**
+   * Compiles a list of channels to hop on with hopToChannel(). Every channel is validated and
+   * turned into the registers tuning the chip on it (calibration included, where needed) now,
+   * so that a hop is just a write of precomputed registers.
+   *
+   * @param freqs channel frequencies (MHz).
+   * @param count number of channels, 1 to RFQUACK_MAX_CHANNELS.
+   *
+   * @return \ref status_codes (\ref ERR_NONE, \ref ERR_NO_SUCH_CHANNEL if count is out of range
+   * or the error of the first invalid channel)
+   */
+  int16_t setChannelPlan(const float *freqs, uint16_t count)
+  {
+    return compileChannels(freqs, 0, 0, count);
+  }
+
+  /**
+   * Same as setChannelPlan(), with count channels evenly spaced from startFreq.
+   */
+  int16_t setChannelRange(float startFreq, float step, uint16_t count)
+  {
+    return compileChannels(nullptr, startFreq, step, count);
+  }
+
+  /**
+   * Tunes the radio on a channel of the plan, staying in the current mode.
+   *
+   * @param index channel index in the plan.
+   *
+   * @return \ref status_codes (\ref ERR_NONE or \ref ERR_NO_SUCH_CHANNEL)
+   */
+  int16_t hopToChannel(uint16_t index)
+  {
+    if (index >= _channelPlan.getCount())
+      return ERR_NO_SUCH_CHANNEL;
+
+    uint64_t hopStart = esp_timer_get_time();
+    RFQChannel &channel = _channelPlan[index];
+    int16_t state = channel.length > 0 ? writeChannel(channel) : setFrequency(channel.freq);
+    uint32_t latencyUs = (uint32_t)(esp_timer_get_time() - hopStart);
+    if (state != RADIOLIB_ERR_NONE)
+      return state;
+
+    _stats.hops++;
+    _stats.hopLatencyLastUs = latencyUs;
+    if (latencyUs > _stats.hopLatencyMaxUs)
+      _stats.hopLatencyMaxUs = latencyUs;
+    return RADIOLIB_ERR_NONE;
+  }
+
+  uint16_t getChannelCount()
+  {
+    return _channelPlan.getCount();
+  }
+
+  float getChannelFrequency(uint16_t index)
+  {
+    return index < _channelPlan.getCount() ? _channelPlan[index].freq : 0;
+  }
+
+  /**
+   * Fills the register image tuning the chip on a frequency, leaving the chip as it was.
+   * Drivers without one only check the frequency, hopToChannel() will call setFrequency().
+   *
+   * @return \ref status_codes
+   */
+  virtual int16_t compileChannel(float freq, RFQChannel &channel)
+  {
+    channel.freq = freq;
+    channel.length = 0;
+    float current;
+    if (getFrequency(&current) != RADIOLIB_ERR_NONE)
+      return RADIOLIB_ERR_NONE;
+
+    // Try it, then go back.
+    int16_t state = setFrequency(freq);
+    setFrequency(current);
+    return state;
+  }
+
+  /**
+   * Writes the register image of a channel compiled by compileChannel().
+   *
+   * @return \ref status_codes
+   */
+  virtual int16_t writeChannel(const RFQChannel &channel)
+  {
+    return ERR_COMMAND_NOT_IMPLEMENTED;
+  }
+
   /**
    * Enables / Disables automatic packet acknowledgement.
    *
@@ -807,33 +1691,258 @@ public:
 
 protected:
   rfquack_Mode _mode = rfquack_Mode_IDLE; // RFQRADIO_MODE_[STANDBY|RX|TX|JAM]
+  RFQRxStream _rxStream;
 
 private:
   char *chipName;
   rfquack_WhichRadio _whichRadio;
+  RFQModemShadow _shadow;
+  bool _shadowValid = false;
+  RFQRadioStats _stats;
+  RFQRxOverflow _rxOverflow;
+  RFQTxQueue _txQueue;
+  RFQRegisterCache _regCache;
+
+  // Channels hopped on by hopToChannel().
+  RFQChannelPlan _channelPlan;
+  bool _txInFlight = false;   // A frame of the front TX job is on air.
+  bool _txWaiting = false;    // The front TX job is waiting for the channel to get free.
+  bool _staged = false;       // A frame is in the chip FIFO, waiting for fireStaged().
+  uint32_t _txFrameStart = 0; // When the current frame started, or started waiting for the channel.
+  uint32_t _txWindowStart = 0; // Start of the window txRate is measured on (ms).
+  uint32_t _txFramesInWindow = 0;
+
+#ifdef RFQUACK_RADIO_THREADED
+  SemaphoreHandle_t _lock;
+#endif
+
+#ifdef RFQUACK_RADIO_RX_TASKS
+  TaskHandle_t volatile _rxTask = NULL;
+  RFQPacketRing *_rxTaskQueue = nullptr;
+
+  static void rxTaskEntry(void *wrapper)
+  {
+    ((RadioLibWrapper<T> *)wrapper)->rxTaskLoop();
+  }
+
+  void rxTaskLoop()
+  {
+    for (;;)
+    {
+      // The timeout covers level triggered IRQ lines, that won't raise an edge for back-to-back packets.
+      // While a long packet comes in, its next bytes are polled for every tick.
+      ulTaskNotifyTake(pdTRUE, isReceivingPacket() ? 1 : pdMS_TO_TICKS(RFQUACK_RADIO_RX_TASK_POLL_MS));
+
+      lock();
+      for (uint8_t i = 0; i < RFQUACK_RADIO_RX_TASK_BURST && (_enableRxInterrupt || isReceivingPacket()) && isIncomingDataAvailable(); i++)
+      {
+        rxLoop(_rxTaskQueue);
+      }
+      unlock();
+    }
+  }
+#endif
 
   /**
-   * Enqueue a packet onto the queue.
-   *
-   * @param[in] packet Packet to enqueue.
-   * @param[out] rxQueue Queue to enqueue packets to.
+   * Compiles the channel plan: freqs if given, count channels spaced by step from startFreq otherwise.
    */
-  void enqueuePacket(rfquack_Packet *packet, Queue *rxQueue)
+  int16_t compileChannels(const float *freqs, float startFreq, float step, uint16_t count)
   {
-    if (packet->data.size > sizeof(rfquack_Packet))
+    if (!_channelPlan.resize(count))
     {
-      RFQUACK_LOG_ERROR(F("Packet payload is grater than container."));
+      RFQUACK_LOG_ERROR(F("Unable to hold %d channels, max %d"), count, RFQUACK_MAX_CHANNELS)
+      return ERR_NO_SUCH_CHANNEL;
+    }
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+      float freq = freqs != nullptr ? freqs[i] : startFreq + (float)i * step;
+      int16_t state = compileChannel(freq, _channelPlan[i]);
+      if (state != RADIOLIB_ERR_NONE)
+      {
+        RFQUACK_LOG_ERROR(F("Channel %d (%d kHz) is not valid, got code %d"), i, (int)(freq * 1000), state)
+        _channelPlan.clear();
+        return state;
+      }
+    }
+    return RADIOLIB_ERR_NONE;
+  }
+
+  /**
+   * Copies the shadowed modem configuration onto a packet.
+   */
+  void stampModemShadow(rfquack_Packet &pkt)
+  {
+    pkt.has_syncWords = _shadow.has_syncWords;
+    pkt.syncWords = _shadow.syncWords;
+    pkt.has_bitRate = _shadow.has_bitRate;
+    pkt.bitRate = _shadow.bitRate;
+    pkt.has_carrierFreq = _shadow.has_carrierFreq;
+    pkt.carrierFreq = _shadow.carrierFreq;
+    pkt.has_frequencyDeviation = _shadow.has_frequencyDeviation;
+    pkt.frequencyDeviation = _shadow.frequencyDeviation;
+    pkt.has_modulation = _shadow.has_modulation;
+    memcpy(pkt.modulation, _shadow.modulation, sizeof(pkt.modulation));
+  }
+
+  /**
+   * Writes the pending value of a register, merging masked writes with its current value.
+   */
+  void flushRegister(uint8_t reg)
+  {
+    uint8_t mask = _regCache.getPendingMask(reg);
+    uint8_t value = _regCache.getPendingValue(reg);
+    if (mask != 0xFF)
+    {
+      uint8_t current;
+      if (!_regCache.get(reg, &current))
+      {
+        current = spiReadRegister(reg);
+        _stats.regSpiReads++;
+      }
+      value = (current & ~mask) | (value & mask);
+    }
+
+    spiWriteRegister(reg, value);
+    _stats.regSpiWrites++;
+    _regCache.set(reg, value);
+    _regCache.clearPending(reg);
+  }
+
+  /**
+   * Accounts a frame of job started at startUs: its lateness, if scheduled, and the TX rate.
+   */
+  void updateTxStats(RFQTxJob *job, uint64_t startUs)
+  {
+    if (job->dueUs != 0)
+    {
+      uint32_t jitterUs = startUs > job->dueUs ? (uint32_t)(startUs - job->dueUs) : 0;
+      _stats.txJitterLastUs = jitterUs;
+      if (jitterUs > _stats.txJitterMaxUs)
+        _stats.txJitterMaxUs = jitterUs;
+      _stats.txJitterAvgUs = _stats.txJitterAvgUs == 0 ? jitterUs : (_stats.txJitterAvgUs * 7 + jitterUs) / 8;
+      if (jitterUs > job->jitterMaxUs)
+        job->jitterMaxUs = jitterUs;
+    }
+
+    _stats.txFrames++;
+    _txFramesInWindow++;
+    uint32_t elapsed = millis() - _txWindowStart;
+    if (elapsed >= 1000)
+    {
+      _stats.txRate = (_txFramesInWindow * 1000) / elapsed;
+      _txFramesInWindow = 0;
+      _txWindowStart = millis();
+    }
+  }
+
+  /**
+   * Accounts the time the radio spent out of RX to serve a packet.
+   */
+  void updateRearmLatency(uint32_t latencyUs)
+  {
+    _stats.rearmLatencyLastUs = latencyUs;
+    if (latencyUs > _stats.rearmLatencyMaxUs)
+      _stats.rearmLatencyMaxUs = latencyUs;
+    _stats.rearmLatencyAvgUs = _stats.rearmLatencyAvgUs == 0 ? latencyUs : (_stats.rearmLatencyAvgUs * 7 + latencyUs) / 8;
+    _stats.minInterPacketGapUs = getMinInterPacketGapUs();
+  }
+
+  /**
+   * Reads what came in of the packet being received; once complete, puts the radio back in RX,
+   * runs onPacketReceived() hooks and enqueues it.
+   */
+  void readPacket(RFQPacketRing *rxQueue)
+  {
+    uint32_t rearmStart = micros();
+
+    // RX left or restarted meanwhile (e.g. a new modem config): the FIFO no longer holds this packet.
+    if (_mode != rfquack_Mode_RX || _enableRxInterrupt)
+    {
+      _rxStream.active = false;
+      packetPool.release(_rxStream.handle);
+      _stats.dropped++;
+      return;
+    }
+
+    uint8_t discard[RFQUACK_RADIO_MAX_MSG_LEN + 1];
+    uint8_t *data = _rxStream.handle != RFQUACK_PACKET_HANDLE_NONE
+                        ? (uint8_t *)packetPool.get(_rxStream.handle)->data.bytes
+                        : discard;
+
+    // Pop packet from RX FIFO.
+    size_t read = 0;
+    int16_t result = readDataChunk(data + _rxStream.read, _rxStream.length - _rxStream.read, &read);
+    _rxStream.read += read;
+    if (result == RADIOLIB_ERR_NONE && _rxStream.read < _rxStream.length)
+    {
+      // Wait for the rest of the packet.
       return;
     }
+    _rxStream.active = false;
+
+    if (result != RADIOLIB_ERR_NONE)
+    {
+      RFQUACK_LOG_ERROR(F("Error while reading data from driver, code=%d"), result);
+    }
 
-    if (rxQueue->isFull())
+    if (_rxStream.handle == RFQUACK_PACKET_HANDLE_NONE)
     {
-      RFQUACK_LOG_ERROR(F("rxQueue is full"));
+      rearmReceive();
+      _stats.dropped++;
       return;
     }
+    rfquack_packet_handle_t handle = _rxStream.handle;
+    rfquack_Packet &pkt = *packetPool.get(handle);
+
+    // RSSI is the only metadata that must come from the chip, read it while it still refers to this packet.
+    pkt.has_RSSI = (getRSSI(&(pkt.RSSI))) == RADIOLIB_ERR_NONE; // Set the RSSI
+
+    RFQUACK_LOG_TRACE(F("Putting radio back in RX"));
+
+    // Put radio back in RX before running the hooks.
+    rearmReceive();
+    updateRearmLatency(micros() - rearmStart);
+
+    // Fill missing data
+    pkt.data.size = _rxStream.length;
+    pkt.rxMicros = _rxStream.rxMicros;
+    pkt.has_rxMicros = true;
+    pkt.millis = _rxStream.rxMicros / 1000;
+    pkt.has_millis = true;
+    pkt.rxRadio = this->_whichRadio;
+    pkt.has_rxRadio = true;
+    strcpy(pkt.model, getChipName());
+    pkt.has_model = true;
+
+    // Modem configuration comes from the shadow, no SPI access.
+    stampModemShadow(pkt);
+
+    // onPacketReceived() hook
+    if (modulesDispatcher.onPacketReceived(pkt, _whichRadio))
+    {
+      // If packet passed filtering put it in rxQueue.
+      enqueuePacket(handle, rxQueue);
+    }
+    else
+    {
+      _stats.filtered++;
+      packetPool.release(handle);
+    }
+  }
+
+  /**
+   * Enqueue a packet handle onto the queue, applying the overflow policy if the queue is full.
+   *
+   * @param[in] handle Handle of the packet to enqueue.
+   * @param[out] rxQueue Queue to enqueue packets to.
+   */
+  void enqueuePacket(rfquack_packet_handle_t handle, RFQPacketRing *rxQueue)
+  {
+    if (!enqueueRxPacket(handle, rxQueue, _rxOverflow, _stats))
+      return;
 
-    rxQueue->push(packet);
-    RFQUACK_LOG_TRACE(F("Packet put in rxQueue, size %d bytes"), packet->data.size);
+    RFQUACK_LOG_TRACE(F("Packet put in rxQueue, size %d bytes"), packetPool.get(handle)->data.size);
   }
 };
 
@@ -169,6 +169,9 @@ void rfquack_setup(RadioA *_radioA, RadioB *_radioB = nullptr, RadioC *_radioC =
   modulesDispatcher.registerModule(radioEModule);
 #endif
 
+  // Describe the commands of every module once, clients fetch it in a few messages.
+  modulesDispatcher.buildCapabilities();
+
   // Delete "loopTask" and recreate it with increased stackDepth.
   RFQUACK_LOG_TRACE(F("Setup is over."))
 
@@ -196,6 +199,14 @@ void rfquack_loop() {
   rfquack_transport_loop();
 
   modulesDispatcher.onLoop();
+
+#if RFQUACK_LOOP_IDLE_SLEEP_MAX_MS > 0
+  // Radios are idle and no module is due: give the CPU away until the next due hook.
+  if (rfqRadio->isIdle()) {
+    uint32_t idleMs = min(modulesDispatcher.getIdleMs(), (uint32_t) RFQUACK_LOOP_IDLE_SLEEP_MAX_MS);
+    if (idleMs > 0) vTaskDelay(pdMS_TO_TICKS(idleMs));
+  }
+#endif
 }
 
 #endif
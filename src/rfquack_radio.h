@@ -27,16 +27,36 @@
 #include "rfquack_transport.h"
 #include "rfquack.pb.h"
 
-#include <cppQueue.h>
 #include "radio/drivers.h"
 #include "defaults/radio.h"
 #include "modules/ModulesDispatcher.h"
 
+#ifdef RFQUACK_RADIO_THREADED
+/**
+ * Holds a radio's lock for the lifetime of the guard, RX tasks are kept away meanwhile.
+ */
+template<typename R>
+class RFQRadioGuard {
+public:
+    explicit RFQRadioGuard(R *radio) : _radio(radio) { _radio->lock(); }
+
+    ~RFQRadioGuard() { _radio->unlock(); }
+
+private:
+    R *_radio;
+};
+
+#define _LOCK_RADIO(radioType, radio) RFQRadioGuard<radioType> radioGuard(radio);
+#else
+#define _LOCK_RADIO(radioType, radio)
+#endif
+
 #define _EXECUTE_CMD(radioType, command){ \
   { \
     rfquack_WhichRadio whichRadio = rfquack_WhichRadio_ ## radioType; \
     (void) whichRadio; \
     radioType *radio = _driver ## radioType; \
+    _LOCK_RADIO(radioType, radio) \
     command; \
   } \
 }
@@ -91,6 +111,17 @@ typedef NoRadio RadioE;
   _SWITCH_RADIO(_whichRadio, RadioE, _EXECUTE_RADIOE(command)) \
 }
 
+// Same as SWITCH_RADIO, for commands that may alter the modem configuration:
+// the radio's modem shadow is marked stale and refreshed on next rxLoop().
+// Pending register writes are sent before, the register cache is dropped as registers are written behind its back.
+#define SWITCH_RADIO_SETTER(_whichRadio, command) \
+  SWITCH_RADIO(_whichRadio, { \
+    radio->invalidateModemShadow(); \
+    radio->flushRegisters(); \
+    radio->invalidateRegisterCache(); \
+    command; \
+  })
+
 // Macro to execute a method on each _radioX
 #define FOREACH_RADIO(command) { \
   _EXECUTE_RADIOA(command) \
@@ -108,12 +139,42 @@ typedef NoRadio RadioE;
 
 extern ModulesDispatcher modulesDispatcher;
 
+// Number of radio slots (RadioA..RadioE), each one has its own RX queue.
+#define RFQUACK_RADIO_SLOTS ((uint8_t) _rfquack_WhichRadio_ARRAYSIZE)
+
+/**
+ * Per radio RX queue scheduling (weight is tunable at runtime) and queueing latency.
+ */
+typedef struct RFQRxSchedule {
+    uint32_t weight = RFQUACK_RADIO_RX_WEIGHT; // Packets drained per round-robin turn.
+    uint32_t deficit = 0; // Packets left in the current turn.
+    uint32_t latencyLastUs = 0; // From ISR to dequeue, read-only.
+    uint32_t latencyMaxUs = 0;
+    uint32_t latencyAvgUs = 0;
+} RFQRxSchedule;
+
+/**
+ * RX queue drain policy (tunable at runtime) and achieved drain rate.
+ */
+typedef struct RFQRxDrain {
+    uint32_t batch = RFQUACK_RADIO_RX_DRAIN_BATCH;
+    uint32_t maxBatch = RFQUACK_RADIO_RX_DRAIN_MAX_BATCH;
+    uint32_t highWatermark = RFQUACK_RADIO_RX_DRAIN_HIGH_WATERMARK;
+    uint32_t lowWatermark = RFQUACK_RADIO_RX_DRAIN_LOW_WATERMARK;
+    uint32_t budgetUs = RFQUACK_RADIO_RX_DRAIN_BUDGET_US;
+    uint32_t rate = 0; // Packets drained per second, read-only.
+
+    // Batch in [1, maxBatch], low watermark below the high one: otherwise the batch would stall or flap.
+    bool isValid() const {
+      return batch >= 1 && batch <= maxBatch && lowWatermark < highWatermark;
+    }
+} RFQRxDrain;
+
 class RFQRadio {
 public:
     explicit RFQRadio(RadioA *_radioA, RadioB *_radioB, RadioC *_radioC, RadioD *_radioD, RadioE *_radioE) :
       _driverRadioA(_radioA), _driverRadioB(_radioB), _driverRadioC(_radioC), _driverRadioD(_radioD),
       _driverRadioE(_radioE) {
-      _rxQueue = new Queue(sizeof(rfquack_Packet), RFQUACK_RADIO_RX_QUEUE_LEN, FIFO, true);
     }
 
     /**
@@ -126,6 +187,18 @@ public:
                       result |= radio->begin();
                       ASSERT_RESULT(result, "Unable to initialize radio")
                     })
+#ifdef RFQUACK_RADIO_RX_TASKS
+      // From now on radios are read by their own RX task.
+      FOREACH_RADIO({ radio->startRxTask(&_rxQueues[whichRadio]); })
+#endif
+#ifdef RFQUACK_RADIO_PIPELINE
+      // From now on radios are read by the radio task, on the other core.
+      if (_radioTask == NULL) {
+        xTaskCreatePinnedToCore(radioTaskEntry, "rfquackRadio", RFQUACK_RADIO_RX_TASK_STACK, this,
+                                RFQUACK_RADIO_RX_TASK_PRIORITY, &_radioTask, RFQUACK_RADIO_PIPELINE_CORE);
+        FOREACH_RADIO({ radio->setRxNotifyTask(_radioTask); })
+      }
+#endif
       return result;
     }
 
@@ -135,59 +208,174 @@ public:
      *
      */
     void txLoop() {
-      // Fetch packets from radios RX FIFOs.
-      FOREACH_RADIO({ radio->txLoop(); })
+      // Register writes are merged within a loop iteration, never held beyond it.
+      FOREACH_RADIO({ radio->flushRegisters(); })
 
-      // Check if any radio still has incoming data available.
-      bool aRadioNeedsCpuTime = false;
-      FOREACH_RADIO({
-                      if (!radio->isTxChannelFree()) aRadioNeedsCpuTime = true;
-                    })
+      // Advance each radio's TX queue.
+      FOREACH_RADIO({ radio->txLoop(); })
     }
     /**
-     * @brief Reads any data from radios to RX queue.
+     * @brief Reads any data from radios to their RX queues, then drains them.
+     *
+     * Up to `rxDrain.batch` packets are handed to the 'afterPacketReceived()' hook
+     * per iteration. The batch doubles (up to `rxDrain.maxBatch`) while the fullest queue stays
+     * above `rxDrain.highWatermark` and goes back to `rxDrain.batch` once it falls below
+     * `rxDrain.lowWatermark`. While a radio still has data to read and the queues are below
+     * the high watermark, the radios are served first. Draining never exceeds
+     * `rxDrain.budgetUs` microseconds, so the other functions in the loop get their share.
      *
-     * We handle them one at a time, even if there are more than one in the queue.
-     * This is because we rather have a full RX queue but zero packet lost, and
-     * we want to give other functions in the loop their share of time.
+     * Queues are drained by deficit round-robin: on its turn a radio's queue gives up to
+     * `rxSchedule[radio].weight` packets, a turn cut short by batch or budget resumes next time.
      */
     void rxLoop() {
+      // Refresh modem shadows changed by setters since last loop.
+      FOREACH_RADIO({ radio->syncModemShadow(); })
+
+#if defined(RFQUACK_RADIO_PIPELINE)
+      // The radio task fills the queue, this loop only drains it.
+      bool aRadioNeedsCpuTime = false;
+#elif defined(RFQUACK_RADIO_RX_TASKS)
+      // Radios with an RX task fill the queue on their own.
+      bool aRadioNeedsCpuTime = false;
+      FOREACH_RADIO({
+                      if (!radio->hasRxTask()) {
+                        radio->rxLoop(&_rxQueues[whichRadio]);
+                        if (radio->isIncomingDataAvailable()) aRadioNeedsCpuTime = true;
+                      }
+                    })
+#else
       // Fetch packets from radios RX FIFOs.
-      FOREACH_RADIO({ radio->rxLoop(_rxQueue); })
+      FOREACH_RADIO({ radio->rxLoop(&_rxQueues[whichRadio]); })
 
       // Check if any radio still has incoming data available.
       bool aRadioNeedsCpuTime = false;
       FOREACH_RADIO({
                       if (radio->isIncomingDataAvailable()) aRadioNeedsCpuTime = true;
                     })
+#endif
 
-      // Execute 'afterPacketReceived()' hook only if there's spare CPU time or queue is getting full.
-      if (!aRadioNeedsCpuTime || _rxQueue->getCount() > 20) {
-        rfquack_Packet pkt;
+      uint32_t count = 0;
+      uint32_t fullest = 0;
+      for (uint8_t i = 0; i < RFQUACK_RADIO_SLOTS; i++) {
+        uint32_t queued = _rxQueues[i].getCount();
+        count += queued;
+        fullest = max(fullest, queued);
+      }
+
+      // Adapt batch size to the queues occupancy.
+      if (fullest >= rxDrain.highWatermark) {
+        _drainBatch = min(max(_drainBatch * 2, rxDrain.batch), rxDrain.maxBatch);
+      } else if (fullest <= rxDrain.lowWatermark) {
+        _drainBatch = rxDrain.batch;
+      }
 
-        // Pick *ONE* packet from RX QUEUE
-        if (_rxQueue->pop(&pkt)) {
-          // Send packet to the chain of registered modules.
-          modulesDispatcher.afterPacketReceived(pkt, pkt.rxRadio);
+      // Execute 'afterPacketReceived()' hook only if there's spare CPU time or a queue is getting full.
+      if (count > 0 && (!aRadioNeedsCpuTime || fullest >= rxDrain.highWatermark)) {
+        uint32_t start = micros();
+        uint32_t drained = 0;
+        uint8_t idle = 0; // Consecutive queues found empty.
+
+        // At least one packet is drained, as it used to be.
+        while (idle < RFQUACK_RADIO_SLOTS &&
+               (drained == 0 || (drained < _drainBatch && micros() - start < rxDrain.budgetUs))) {
+          RFQRxSchedule &schedule = rxSchedule[_drrNext];
+          if (schedule.deficit == 0) schedule.deficit = max(schedule.weight, (uint32_t) 1);
+
+          if (drainPacket((rfquack_WhichRadio) _drrNext)) {
+            schedule.deficit--;
+            drained++;
+            idle = 0;
+          } else {
+            // An empty queue doesn't keep its credit.
+            schedule.deficit = 0;
+            idle++;
+          }
+
+          if (schedule.deficit == 0) _drrNext = (_drrNext + 1) % RFQUACK_RADIO_SLOTS;
         }
+
+        _drainedInWindow += drained;
       }
 
+      // Update drain rate (packets per second) once per window.
+      uint32_t elapsed = millis() - _drainWindowStart;
+      if (elapsed >= 1000) {
+        rxDrain.rate = (_drainedInWindow * 1000) / elapsed;
+        _drainedInWindow = 0;
+        _drainWindowStart = millis();
+      }
+    }
+
+    /**
+     * @return whether the main loop has nothing to do for radios: RX queues are empty and
+     * no radio is transmitting or waiting for packets it must read.
+     */
+    bool isIdle() {
+      for (uint8_t i = 0; i < RFQUACK_RADIO_SLOTS; i++) {
+        if (_rxQueues[i].getCount() > 0) return false;
+      }
+      bool idle = true;
+      FOREACH_RADIO({ if (!radio->isIdle()) idle = false; })
+      return idle;
     }
 
     /**
      * Sends a packet over the air.
      * 
+     * The packet is queued, the call returns without waiting for it to be on air.
+     *
      * @param pkt Packet to be sent.
      * @param whichRadio Choosen radio.
+     * @param[out] jobId id of the transmission job, may be nullptr.
      * 
      * @return \ref status_codes
      */
-    int16_t transmit(rfquack_Packet *pkt, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->transmit(pkt))
+    int16_t transmit(rfquack_Packet *pkt, rfquack_WhichRadio whichRadio, uint32_t *jobId = nullptr) {
+      SWITCH_RADIO(whichRadio, return radio->transmit(pkt, jobId))
+      unableToFindRadioError();
+      return RADIOLIB_ERR_UNKNOWN;
+    }
+
+    /**
+     * Uploads a packet to the radio, to be sent later by fireStaged().
+     *
+     * @param pkt Packet to be sent.
+     * @param whichRadio Choosen radio.
+     *
+     * @return \ref status_codes
+     */
+    int16_t stageTransmit(rfquack_Packet *pkt, rfquack_WhichRadio whichRadio) {
+      SWITCH_RADIO(whichRadio, return radio->stageTransmit(pkt->data.bytes, pkt->data.size))
+      unableToFindRadioError();
+      return RADIOLIB_ERR_UNKNOWN;
+    }
+
+    /**
+     * Sends the packet staged by stageTransmit().
+     *
+     * @param whichRadio Choosen radio.
+     *
+     * @return \ref status_codes
+     */
+    int16_t fireStaged(rfquack_WhichRadio whichRadio) {
+      SWITCH_RADIO(whichRadio, return radio->fireStaged())
       unableToFindRadioError();
       return RADIOLIB_ERR_UNKNOWN;
     }
 
+    /**
+     * Takes the report of a completed transmission job.
+     *
+     * @param[out] report
+     * @param whichRadio Choosen radio.
+     *
+     * @return false if there's none.
+     */
+    bool popTxReport(rfquack_WhichRadio whichRadio, rfquack_TxReport *report) {
+      SWITCH_RADIO(whichRadio, return radio->popTxReport(report))
+      return false;
+    }
+
     /**
      * Read register value.
      * 
@@ -208,23 +396,64 @@ public:
      *
      */
     void writeRegister(uint8_t reg, uint8_t value, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->writeRegister(reg, value, 7, 0))
-      unableToFindRadioError();
+      writeRegister(reg, value, 7, 0, whichRadio);
     }
 
+    /**
+     * Write value to some bits of a register (value is already positioned between msb and lsb).
+     * Writes are merged per register and sent by flushRegisters(), at the latest by the next txLoop().
+     */
     void writeRegister(uint8_t reg, uint8_t value, uint8_t msb, uint8_t lsb, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->writeRegister(reg, value, msb, lsb))
+      SWITCH_RADIO(whichRadio, {
+        radio->invalidateModemShadow();
+        return radio->writeRegister(reg, value, msb, lsb);
+      })
+      unableToFindRadioError();
+    }
+
+    /**
+     * Read len consecutive registers from first, in a single burst where the chip allows it.
+     */
+    int16_t readRegisterBlock(uint8_t first, uint8_t len, uint8_t *values, rfquack_WhichRadio whichRadio) {
+      SWITCH_RADIO(whichRadio, return radio->readRegisterBlock(first, len, values))
+      unableToFindRadioError();
+      return RADIOLIB_ERR_UNKNOWN;
+    }
+
+    /**
+     * Write len consecutive registers from first, in a single burst where the chip allows it.
+     */
+    int16_t writeRegisterBlock(uint8_t first, uint8_t len, const uint8_t *values, rfquack_WhichRadio whichRadio) {
+      SWITCH_RADIO(whichRadio, {
+        radio->invalidateModemShadow();
+        return radio->writeRegisterBlock(first, len, values);
+      })
+      unableToFindRadioError();
+      return RADIOLIB_ERR_UNKNOWN;
+    }
+
+    /**
+     * Sends pending register writes to the chip.
+     */
+    void flushRegisters(rfquack_WhichRadio whichRadio) {
+      SWITCH_RADIO(whichRadio, return radio->flushRegisters())
       unableToFindRadioError();
     }
 
     int16_t fixedPacketLengthMode(uint8_t len, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->fixedPacketLengthMode(len));
+      SWITCH_RADIO_SETTER(whichRadio, return radio->fixedPacketLengthMode(len));
       unableToFindRadioError();
       return RADIOLIB_ERR_UNKNOWN;
     }
 
     int16_t variablePacketLengthMode(uint8_t len, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->variablePacketLengthMode(len));
+      SWITCH_RADIO_SETTER(whichRadio, return radio->variablePacketLengthMode(len));
+      unableToFindRadioError();
+      return RADIOLIB_ERR_UNKNOWN;
+    }
+
+    int16_t infinitePacketLengthMode(uint8_t captureLen, rfquack_WhichRadio whichRadio) {
+      SWITCH_RADIO_SETTER(whichRadio, return radio->infinitePacketLengthMode(captureLen));
       unableToFindRadioError();
       return RADIOLIB_ERR_UNKNOWN;
     }
@@ -236,13 +465,13 @@ public:
      * @return
      */
     int16_t setMode(rfquack_Mode mode, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->setMode(mode))
+      SWITCH_RADIO_SETTER(whichRadio, return radio->setMode(mode))
       unableToFindRadioError();
       return RADIOLIB_ERR_UNKNOWN;
     }
 
     int16_t setAutoAck(bool autoAckOn, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->setAutoAck(autoAckOn))
+      SWITCH_RADIO_SETTER(whichRadio, return radio->setAutoAck(autoAckOn))
       unableToFindRadioError();
       return RADIOLIB_ERR_UNKNOWN;
     }
@@ -273,61 +502,122 @@ public:
     }
 
     int16_t setFrequency(float carrierFreq, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->setFrequency(carrierFreq))
+      SWITCH_RADIO_SETTER(whichRadio, return radio->setFrequency(carrierFreq))
       unableToFindRadioError();
       return RADIOLIB_ERR_UNKNOWN;
     }
 
     int16_t setOutputPower(uint32_t power, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->setOutputPower(power))
+      SWITCH_RADIO_SETTER(whichRadio, return radio->setOutputPower(power))
       unableToFindRadioError();
       return RADIOLIB_ERR_UNKNOWN;
     }
 
     int16_t setPreambleLength(uint32_t size, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->setPreambleLength(size))
+      SWITCH_RADIO_SETTER(whichRadio, return radio->setPreambleLength(size))
       unableToFindRadioError();
       return RADIOLIB_ERR_UNKNOWN;
     }
 
     int16_t setSyncWord(uint8_t *bytes, uint8_t size, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->setSyncWord(bytes, size))
+      SWITCH_RADIO_SETTER(whichRadio, return radio->setSyncWord(bytes, size))
       unableToFindRadioError();
       return RADIOLIB_ERR_UNKNOWN;
     }
 
     int16_t setModulation(rfquack_Modulation modulation, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->setModulation(modulation))
+      SWITCH_RADIO_SETTER(whichRadio, return radio->setModulation(modulation))
       unableToFindRadioError();
       return RADIOLIB_ERR_UNKNOWN;
     }
 
     int16_t setCrcFiltering(bool useCRC, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->setCrcFiltering(useCRC))
+      SWITCH_RADIO_SETTER(whichRadio, return radio->setCrcFiltering(useCRC))
       unableToFindRadioError();
       return RADIOLIB_ERR_UNKNOWN;
     }
 
     int16_t setRxBandwidth(float rxBandwidth, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->setRxBandwidth(rxBandwidth))
+      SWITCH_RADIO_SETTER(whichRadio, return radio->setRxBandwidth(rxBandwidth))
       unableToFindRadioError();
       return RADIOLIB_ERR_UNKNOWN;
     }
 
     int16_t setBitRate(float bitRate, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->setBitRate(bitRate))
+      SWITCH_RADIO_SETTER(whichRadio, return radio->setBitRate(bitRate))
       unableToFindRadioError();
       return RADIOLIB_ERR_UNKNOWN;
     }
 
     int16_t setFrequencyDeviation(float frequencyDeviation, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->setFrequencyDeviation(frequencyDeviation))
+      SWITCH_RADIO_SETTER(whichRadio, return radio->setFrequencyDeviation(frequencyDeviation))
+      unableToFindRadioError();
+      return RADIOLIB_ERR_UNKNOWN;
+    }
+
+    int16_t applyModemConfig(rfquack_ModemConfig &cfg, rfquack_WhichRadio whichRadio) {
+      SWITCH_RADIO_SETTER(whichRadio, return radio->applyModemConfig(cfg))
       unableToFindRadioError();
       return RADIOLIB_ERR_UNKNOWN;
     }
 
+    int16_t saveProfile(RFQModemProfile &profile, rfquack_WhichRadio whichRadio) {
+      // Pending register writes belong to the configuration being captured.
+      SWITCH_RADIO(whichRadio, { radio->flushRegisters(); return radio->saveProfile(profile); })
+      unableToFindRadioError();
+      return RADIOLIB_ERR_UNKNOWN;
+    }
+
+    int16_t loadProfile(const RFQModemProfile &profile, rfquack_WhichRadio whichRadio) {
+      SWITCH_RADIO_SETTER(whichRadio, return radio->loadProfile(profile))
+      unableToFindRadioError();
+      return RADIOLIB_ERR_UNKNOWN;
+    }
+
+    int16_t takeSnapshot(RFQRadioSnapshot &snapshot, rfquack_WhichRadio whichRadio) {
+      SWITCH_RADIO(whichRadio, { radio->flushRegisters(); return radio->takeSnapshot(snapshot); })
+      unableToFindRadioError();
+      return RADIOLIB_ERR_UNKNOWN;
+    }
+
+    int16_t restoreSnapshot(RFQRadioSnapshot &snapshot, rfquack_WhichRadio whichRadio) {
+      SWITCH_RADIO_SETTER(whichRadio, return radio->restoreSnapshot(snapshot))
+      unableToFindRadioError();
+      return RADIOLIB_ERR_UNKNOWN;
+    }
+
+    int16_t setChannelPlan(const float *freqs, uint16_t count, rfquack_WhichRadio whichRadio) {
+      SWITCH_RADIO_SETTER(whichRadio, return radio->setChannelPlan(freqs, count))
+      unableToFindRadioError();
+      return RADIOLIB_ERR_UNKNOWN;
+    }
+
+    int16_t setChannelRange(float startFreq, float step, uint16_t count, rfquack_WhichRadio whichRadio) {
+      SWITCH_RADIO_SETTER(whichRadio, return radio->setChannelRange(startFreq, step, count))
+      unableToFindRadioError();
+      return RADIOLIB_ERR_UNKNOWN;
+    }
+
+    int16_t hopToChannel(uint16_t index, rfquack_WhichRadio whichRadio) {
+      SWITCH_RADIO_SETTER(whichRadio, return radio->hopToChannel(index))
+      unableToFindRadioError();
+      return RADIOLIB_ERR_UNKNOWN;
+    }
+
+    uint16_t getChannelCount(rfquack_WhichRadio whichRadio) {
+      SWITCH_RADIO(whichRadio, return radio->getChannelCount())
+      unableToFindRadioError();
+      return 0;
+    }
+
+    float getChannelFrequency(uint16_t index, rfquack_WhichRadio whichRadio) {
+      SWITCH_RADIO(whichRadio, return radio->getChannelFrequency(index))
+      unableToFindRadioError();
+      return 0;
+    }
+
     int16_t setPromiscuousMode(bool enabled, rfquack_WhichRadio whichRadio) {
-      SWITCH_RADIO(whichRadio, return radio->setPromiscuousMode(enabled))
+      SWITCH_RADIO_SETTER(whichRadio, return radio->setPromiscuousMode(enabled))
       unableToFindRadioError();
       return RADIOLIB_ERR_UNKNOWN;
     }
@@ -345,12 +635,109 @@ public:
       return RADIOLIB_ERR_UNKNOWN;
     }
 
+    /**
+     * @brief Get RX statistics of a radio.
+     *
+     * @param whichRadio
+     * @return pointer to statistics, never null (zeroed statistics if radio is not found).
+     */
+    RFQRadioStats *getRadioStats(rfquack_WhichRadio whichRadio) {
+      static RFQRadioStats noStats;
+      SWITCH_RADIO(whichRadio, return radio->getStats())
+      unableToFindRadioError();
+      return &noStats;
+    }
+
+    /**
+     * @brief Get RX queue overflow policy of a radio.
+     *
+     * @param whichRadio
+     * @return pointer to the policy, never null (a detached default if radio is not found).
+     */
+    RFQRxOverflow *getRxOverflow(rfquack_WhichRadio whichRadio) {
+      static RFQRxOverflow noOverflow;
+      SWITCH_RADIO(whichRadio, return radio->getRxOverflow())
+      unableToFindRadioError();
+      return &noOverflow;
+    }
+
     void unableToFindRadioError() {
       RFQUACK_LOG_ERROR(F("Unable to find radio"));
     }
 
+    /**
+     * @brief Get the RX queue of a radio, for its drop and occupancy stats.
+     */
+    RFQPacketRing *getRxQueue(rfquack_WhichRadio whichRadio) {
+      return &_rxQueues[whichRadio];
+    }
+
+    RFQRxDrain rxDrain;
+    RFQRxSchedule rxSchedule[RFQUACK_RADIO_SLOTS];
+
 private:
-    Queue *_rxQueue;
+    // The queues hold packet pool handles, packets themselves are never copied.
+    RFQPacketRing _rxQueues[RFQUACK_RADIO_SLOTS];
+    uint8_t _drrNext = 0;
+    uint32_t _drainBatch = RFQUACK_RADIO_RX_DRAIN_BATCH;
+    uint32_t _drainedInWindow = 0;
+    uint32_t _drainWindowStart = 0;
+
+    /**
+     * Pops a packet from a radio's RX queue and sends it to the chain of registered modules.
+     *
+     * @return false if the queue is empty.
+     */
+    bool drainPacket(rfquack_WhichRadio whichRadio) {
+      rfquack_packet_handle_t handle;
+      if (!_rxQueues[whichRadio].pop(&handle)) return false;
+
+      rfquack_Packet *pkt = packetPool.get(handle);
+      if (pkt->has_rxMicros) {
+        uint32_t latencyUs = (uint32_t) (esp_timer_get_time() - pkt->rxMicros);
+        pkt->isrToDequeueUs = latencyUs;
+        pkt->has_isrToDequeueUs = true;
+
+        RFQRxSchedule &schedule = rxSchedule[whichRadio];
+        schedule.latencyLastUs = latencyUs;
+        schedule.latencyMaxUs = max(schedule.latencyMaxUs, latencyUs);
+        schedule.latencyAvgUs = schedule.latencyAvgUs == 0 ? latencyUs : (schedule.latencyAvgUs * 7 + latencyUs) / 8;
+      }
+
+      // Give the slot back once modules are done with it.
+      modulesDispatcher.afterPacketReceived(*pkt, pkt->rxRadio);
+      packetPool.release(handle);
+      return true;
+    }
+#ifdef RFQUACK_RADIO_PIPELINE
+    TaskHandle_t _radioTask = NULL;
+
+    static void radioTaskEntry(void *rfqRadio) {
+      ((RFQRadio *) rfqRadio)->radioTaskLoop();
+    }
+
+    /**
+     * Reads radios into the RX queue, 'onPacketReceived()' hooks included.
+     * Sleeps until a radio interrupt (or the poll period) once FIFOs are empty.
+     */
+    void radioTaskLoop() {
+      uint8_t burst = 0;
+      for (;;) {
+        bool aRadioNeedsCpuTime = false;
+        FOREACH_RADIO({
+                        radio->rxLoop(&_rxQueues[whichRadio]);
+                        // A long packet coming in is polled for every tick.
+                        if (radio->isIncomingDataAvailable() || radio->isReceivingPacket()) aRadioNeedsCpuTime = true;
+                      })
+
+        if (aRadioNeedsCpuTime && ++burst < RFQUACK_RADIO_RX_TASK_BURST) continue;
+
+        // Always block a little, so lower priority tasks on this core are not starved.
+        burst = 0;
+        ulTaskNotifyTake(pdTRUE, aRadioNeedsCpuTime ? 1 : pdMS_TO_TICKS(RFQUACK_RADIO_RX_TASK_POLL_MS));
+      }
+    }
+#endif
     RadioA *_driverRadioA = nullptr;
     RadioB *_driverRadioB = nullptr;
     RadioC *_driverRadioC = nullptr;
@@ -0,0 +1,134 @@
+// Packet hooks over N modules, one in four implementing them: the dynamic_cast walk over every module,
+// as before the hook lists, against ModulesDispatcher's hook lists.
+
+#include "check.h"
+#include "modules/ModulesDispatcher.h"
+#include "host_transport.h"
+
+static const uint32_t ITERATIONS = 200000;
+static const uint8_t HOOKED_EVERY = 4;
+
+/**
+ * A module without packet hooks.
+ */
+class PlainModule : public RFQModule {
+public:
+    PlainModule(const char *name) : RFQModule(name) {}
+
+    void onInit() override {
+      this->enabled = true;
+    }
+
+    void executeUserCommand(char *verb, char **args, uint8_t argsLen, char *messagePayload,
+                            unsigned int messageLen) override {}
+};
+
+/**
+ * A module counting the packets it's handed.
+ */
+class HookedModule : public RFQModule, public OnPacketReceived, public AfterPacketReceived {
+public:
+    HookedModule(const char *name) : RFQModule(name) {}
+
+    void onInit() override {
+      this->enabled = true;
+    }
+
+    bool onPacketReceived(rfquack_Packet &pkt, rfquack_WhichRadio whichRadio) override {
+      onPacketReceivedCalls++;
+      return true;
+    }
+
+    bool afterPacketReceived(rfquack_Packet &pkt, rfquack_WhichRadio whichRadio) override {
+      afterPacketReceivedCalls++;
+      return true;
+    }
+
+    void executeUserCommand(char *verb, char **args, uint8_t argsLen, char *messagePayload,
+                            unsigned int messageLen) override {}
+
+    uint32_t onPacketReceivedCalls = 0;
+    uint32_t afterPacketReceivedCalls = 0;
+};
+
+static char names[RFQUACK_MAX_MODULES][16];
+static RFQModule *modules[RFQUACK_MAX_MODULES];
+static HookedModule *hooked[RFQUACK_MAX_MODULES];
+static uint8_t loadedModules;
+static uint8_t hookedModules;
+
+// Packet hooks before the hook lists: every enabled module is cast to each hook.
+static bool castOnPacketReceived(rfquack_Packet &packet, rfquack_WhichRadio whichRadio) {
+  for (int i = 0; i < loadedModules; i++) {
+    RFQModule *module = modules[i];
+    if (module->isEnabled()) {
+      if (OnPacketReceived *mdl = dynamic_cast<OnPacketReceived *>(module)) {
+        if (!mdl->onPacketReceived(packet, whichRadio)) return false;
+      }
+    }
+  }
+  return true;
+}
+
+static bool castAfterPacketReceived(rfquack_Packet &packet, rfquack_WhichRadio whichRadio) {
+  for (int i = 0; i < loadedModules; i++) {
+    RFQModule *module = modules[i];
+    if (module->isEnabled()) {
+      if (AfterPacketReceived *mdl = dynamic_cast<AfterPacketReceived *>(module)) {
+        if (!mdl->afterPacketReceived(packet, whichRadio)) return false;
+      }
+    }
+  }
+  return true;
+}
+
+static rfquack_Packet packet = rfquack_Packet_init_zero;
+
+static void run(uint8_t count) {
+  // Never freed, the benchmark exits right after.
+  ModulesDispatcher *dispatcher = new ModulesDispatcher();
+  loadedModules = 0;
+  hookedModules = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    snprintf(names[i], sizeof(names[i]), "module%d", i);
+    if (i % HOOKED_EVERY == HOOKED_EVERY - 1) {
+      HookedModule *module = new HookedModule(names[i]);
+      dispatcher->registerModule(module);
+      modules[loadedModules++] = module;
+      hooked[hookedModules++] = module;
+    } else {
+      PlainModule *module = new PlainModule(names[i]);
+      dispatcher->registerModule(module);
+      modules[loadedModules++] = module;
+    }
+  }
+
+  double castNs = benchmark(ITERATIONS, [](uint32_t i) {
+    if (castOnPacketReceived(packet, rfquack_WhichRadio_RadioA)) {
+      benchmarkSink += castAfterPacketReceived(packet, rfquack_WhichRadio_RadioA);
+    }
+  });
+
+  double listNs = benchmark(ITERATIONS, [dispatcher](uint32_t i) {
+    if (dispatcher->onPacketReceived(packet, rfquack_WhichRadio_RadioA)) {
+      benchmarkSink += dispatcher->afterPacketReceived(packet, rfquack_WhichRadio_RadioA);
+    }
+  });
+
+  // Both ways call every hook once per packet, and only those.
+  CHECK_EQ(hookedModules, count / HOOKED_EVERY)
+  for (uint8_t i = 0; i < hookedModules; i++) {
+    CHECK_EQ(hooked[i]->onPacketReceivedCalls, 2 * ITERATIONS)
+    CHECK_EQ(hooked[i]->afterPacketReceivedCalls, 2 * ITERATIONS)
+  }
+
+  printf("%2d modules, %d hooked: dynamic_cast %6.1f ns/packet, hook lists %6.1f ns/packet\n",
+         count, hookedModules, castNs, listNs);
+}
+
+int main() {
+  run(4);
+  run(8);
+  run(16);
+  return CHECK_RESULT();
+}
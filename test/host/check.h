@@ -0,0 +1,46 @@
+#ifndef RFQUACK_HOST_CHECK_H
+#define RFQUACK_HOST_CHECK_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+
+/**
+ * Minimal checks for host builds: a failed CHECK prints its location and fails the program,
+ * CHECK_RESULT() is the exit code of main().
+ */
+inline int checkFailures = 0;
+
+#define CHECK(condition) { \
+  if (!(condition)) { \
+    fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+    checkFailures++; \
+  } \
+}
+
+#define CHECK_EQ(actual, expected) { \
+  long long _actual = (long long) (actual), _expected = (long long) (expected); \
+  if (_actual != _expected) { \
+    fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #actual, #expected, \
+            _actual, _expected); \
+    checkFailures++; \
+  } \
+}
+
+#define CHECK_RESULT() (checkFailures == 0 ? 0 : 1)
+
+/**
+ * Runs fn iterations times, returns the average time of a call in nanoseconds.
+ */
+template<typename F>
+double benchmark(uint32_t iterations, F fn) {
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < iterations; i++) fn(i);
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / iterations;
+}
+
+// Keeps the compiler from optimizing away what a benchmark computes.
+inline volatile uint32_t benchmarkSink = 0;
+
+#endif //RFQUACK_HOST_CHECK_H
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+#
+# Generates rfquack.pb.h for host builds, without nanopb: message structs and enums laid out
+# as nanopb would (max_size / max_count from rfquack.options), no encoding descriptors.
+# Host checks only fill and read structs, messages are never encoded.
+#
+# usage: generate_pb_structs.py rfquack.proto rfquack.options > rfquack.pb.h
+
+import re
+import sys
+
+SCALARS = {
+    'bool': 'bool',
+    'double': 'double',
+    'fixed32': 'uint32_t',
+    'float': 'float',
+    'int32': 'int32_t',
+    'int64': 'int64_t',
+    'sint32': 'int32_t',
+    'uint32': 'uint32_t',
+    'uint64': 'uint64_t',
+}
+
+
+def parse_options(path):
+    options = {}
+    for line in open(path):
+        line = line.strip()
+        if not line or line.startswith('#'):
+            continue
+        name, *settings = line.split()
+        for setting in settings:
+            key, value = setting.split(':')
+            options.setdefault(name, {})[key] = value
+    return options
+
+
+class Parser:
+    def __init__(self, source):
+        source = re.sub(r'//[^\n]*', '', source)
+        self.tokens = re.findall(r'[A-Za-z_][A-Za-z0-9_.]*|-?\d+|[{};=\[\]]', source)
+        self.pos = 0
+        self.enums = []     # (c name, [(value name, number)])
+        self.messages = []  # (c name, proto name, [(label, type, name)])
+
+    def parse(self):
+        while self.pos < len(self.tokens):
+            token = self.tokens[self.pos]
+            if token == 'enum':
+                self.parse_enum('rfquack_')
+            elif token == 'message':
+                self.parse_message('rfquack_', 'rfquack')
+            else:
+                self.pos += 1
+
+    def parse_enum(self, prefix):
+        name = self.tokens[self.pos + 1]
+        self.pos += 3
+        values = []
+        while self.tokens[self.pos] != '}':
+            values.append((self.tokens[self.pos], self.tokens[self.pos + 2]))
+            self.pos += 4
+        self.pos += 1
+        self.enums.append((prefix + name, values))
+        return name
+
+    def parse_message(self, prefix, parent):
+        name = self.tokens[self.pos + 1]
+        self.pos += 3
+        cname, full = prefix + name, parent + '.' + name
+        fields, nested_enums = [], {}
+        while self.tokens[self.pos] != '}':
+            if self.tokens[self.pos] == 'enum':
+                enum = self.parse_enum(cname + '_')
+                nested_enums[enum] = cname + '_' + enum
+                continue
+            if self.tokens[self.pos] == 'message':
+                self.parse_message(cname + '_', full)
+                continue
+            label, type_, field = self.tokens[self.pos:self.pos + 3]
+            self.pos += 5
+            if self.tokens[self.pos] == '[':
+                while self.tokens[self.pos] != ']':
+                    self.pos += 1
+                self.pos += 1
+            self.pos += 1
+            fields.append((label, nested_enums.get(type_, type_), field))
+        self.pos += 1
+        self.messages.append((cname, full, fields))
+
+
+def generate(parser, options):
+    enums = {cname for cname, _ in parser.enums}
+    messages = {cname for cname, _, _ in parser.messages}
+
+    def c_type(type_):
+        if type_ in SCALARS:
+            return SCALARS[type_]
+        for candidate in (type_, 'rfquack_' + type_):
+            if candidate in enums or candidate in messages:
+                return candidate
+        raise ValueError('unknown type ' + type_)
+
+    out = ['// Generated by generate_pb_structs.py, do not edit.', '#pragma once', '#include <pb.h>', '']
+
+    for cname, values in parser.enums:
+        out.append('typedef enum _%s {' % cname)
+        out.append(',\n'.join('    %s_%s = %s' % (cname, value, number) for value, number in values))
+        out.append('} %s;' % cname)
+        lowest = min(values, key=lambda v: int(v[1]))[0]
+        highest = max(values, key=lambda v: int(v[1]))[0]
+        out.append('#define _%s_MIN %s_%s' % (cname, cname, lowest))
+        out.append('#define _%s_MAX %s_%s' % (cname, cname, highest))
+        out.append('#define _%s_ARRAYSIZE ((%s)(%s_%s+1))' % (cname, cname, cname, highest))
+        out.append('')
+
+    # Structs are emitted after the structs they embed.
+    emitted, pending = set(), list(parser.messages)
+    while pending:
+        for message in pending:
+            deps = [c_type(t) for _, t, _ in message[2] if t not in ('string', 'bytes')]
+            if all(dep in emitted or dep not in messages for dep in deps):
+                break
+        pending.remove(message)
+        cname, full, fields = message
+        emitted.add(cname)
+
+        body = []
+        for label, type_, field in fields:
+            option = options.get(full + '.' + field, {})
+            if type_ == 'bytes' and 'max_size' in option:
+                out.append('typedef PB_BYTES_ARRAY_T(%s) %s_%s_t;' % (option['max_size'], cname, field))
+                member, array = '%s_%s_t' % (cname, field), ''
+            elif type_ == 'string' and 'max_size' in option:
+                member, array = 'char', '[%s]' % option['max_size']
+            elif type_ in ('bytes', 'string'):
+                member, array = 'pb_callback_t', ''
+            else:
+                member, array = c_type(type_), ''
+
+            if label == 'repeated':
+                if 'max_count' in option and member != 'pb_callback_t':
+                    body.append('    pb_size_t %s_count;' % field)
+                    array = '[%s]%s' % (option['max_count'], array)
+                else:
+                    member, array = 'pb_callback_t', ''
+            elif label == 'optional' and member != 'pb_callback_t':
+                body.append('    bool has_%s;' % field)
+            body.append('    %s %s%s;' % (member, field, array))
+
+        out.append('typedef struct _%s {' % cname)
+        out.extend(body or ['    char dummy_field;'])
+        out.append('} %s;' % cname)
+        out.append('inline const pb_msgdesc_t %s_msg = {0};' % cname)
+        out.append('#define %s_fields &%s_msg' % (cname, cname))
+        out.append('#define %s_init_zero {}' % cname)
+        out.append('#define %s_init_default {}' % cname)
+        out.append('')
+
+    return '\n'.join(out)
+
+
+if __name__ == '__main__':
+    parser = Parser(open(sys.argv[1]).read())
+    parser.parse()
+    print(generate(parser, parse_options(sys.argv[2])))
@@ -0,0 +1,16 @@
+#ifndef RFQUACK_HOST_TRANSPORT_H
+#define RFQUACK_HOST_TRANSPORT_H
+
+#include <stdint.h>
+
+/**
+ * Transport of host builds: messages are counted, not sent.
+ */
+inline uint32_t hostTransportMessages = 0;
+
+uint32_t rfquack_transport_send(const char *topic, const uint8_t *data, uint32_t len) {
+  hostTransportMessages++;
+  return len;
+}
+
+#endif //RFQUACK_HOST_TRANSPORT_H
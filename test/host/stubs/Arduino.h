@@ -0,0 +1,95 @@
+// Host stub of the Arduino-ESP32 core: clock, GPIO and FreeRTOS calls used by the headers under test.
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+class __FlashStringHelper;
+#define F(x) (x)
+#define PGM_P const char *
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define IRAM_ATTR
+#define HIGH 1
+#define LOW 0
+#define RISING 1
+#define CONFIG_ARDUINO_RUNNING_CORE 1
+
+using std::min;
+using std::max;
+
+inline uint64_t hostMicros() {
+  static const auto boot = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - boot).count();
+}
+
+inline unsigned long millis() { return (unsigned long) (hostMicros() / 1000); }
+inline unsigned long micros() { return (unsigned long) hostMicros(); }
+inline void delay(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+inline void delayMicroseconds(uint32_t us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+inline int digitalRead(uint8_t) { return LOW; }
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalPinToInterrupt(int pin) { return pin; }
+inline void attachInterruptArg(uint8_t, void (*)(void *), void *, int) {}
+inline void detachInterrupt(uint8_t) {}
+inline long random(long max) { return rand() % max; }
+inline long random(long min, long max) { return min + rand() % (max - min); }
+
+class Print {
+public:
+    size_t write(uint8_t) { return 1; }
+    size_t write(const uint8_t *, size_t len) { return len; }
+    size_t print(const char *) { return 0; }
+    size_t print(char) { return 0; }
+    size_t println(const char *) { return 0; }
+    size_t println() { return 0; }
+};
+
+class HardwareSerial : public Print {
+};
+
+inline HardwareSerial Serial;
+
+// Cycle counter: the TSC on x86 hosts, nanoseconds elsewhere. Either way reported as a 1 GHz CPU,
+// so hook timings are only indicative on the host.
+class EspClass {
+public:
+    uint32_t getCycleCount() {
+#if defined(__x86_64__) || defined(__i386__)
+      return (uint32_t) __rdtsc();
+#else
+      return (uint32_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    uint32_t getCpuFreqMHz() { return 1000; }
+};
+
+inline EspClass ESP;
+
+// FreeRTOS, single threaded on the host.
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+typedef void *TaskHandle_t;
+typedef void *QueueHandle_t;
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdMS_TO_TICKS(x) ((TickType_t)(x))
+#define portYIELD_FROM_ISR()
+
+inline void vTaskNotifyGiveFromISR(TaskHandle_t, BaseType_t *) {}
+inline void vTaskDelay(TickType_t ticks) { delay(ticks); }
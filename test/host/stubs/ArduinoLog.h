@@ -0,0 +1,28 @@
+// Host stub of ArduinoLog: logging is discarded.
+#pragma once
+#include "Arduino.h"
+
+#define LOG_LEVEL_SILENT 0
+#define LOG_LEVEL_FATAL 1
+#define LOG_LEVEL_ERROR 2
+#define LOG_LEVEL_WARNING 3
+#define LOG_LEVEL_NOTICE 4
+#define LOG_LEVEL_TRACE 5
+#define LOG_LEVEL_VERBOSE 6
+
+typedef void (*printfunction)(Print *);
+
+class Logging {
+public:
+    template<class... A> void fatal(A...) {}
+    template<class... A> void error(A...) {}
+    template<class... A> void warning(A...) {}
+    template<class... A> void notice(A...) {}
+    template<class... A> void trace(A...) {}
+    template<class... A> void verbose(A...) {}
+    void begin(int, Print *) {}
+    void setPrefix(printfunction) {}
+    void setSuffix(printfunction) {}
+};
+
+inline Logging Log;
@@ -0,0 +1,25 @@
+// Host stub of RadioLib: status codes and the Module class, enough to compile RadioLibWrapper.
+#pragma once
+#include "Arduino.h"
+
+#define RADIOLIB_NC 0xFFFFFFFF
+#define RADIOLIB_ERR_NONE 0
+#define RADIOLIB_ERR_UNKNOWN -1
+#define RADIOLIB_ERR_PACKET_TOO_LONG -4
+#define RADIOLIB_ERR_TX_TIMEOUT -5
+#define RADIOLIB_ERR_RX_TIMEOUT -6
+#define RADIOLIB_ERR_CRC_MISMATCH -7
+#define RADIOLIB_ERR_INVALID_FREQUENCY -12
+#define RADIOLIB_ERR_UNSUPPORTED_ENCODING -402
+
+class Module {
+public:
+    Module(uint32_t cs, uint32_t irq, uint32_t rst, uint32_t gpio = RADIOLIB_NC) : _irq(irq) {}
+
+    uint32_t getIrq() const {
+      return _irq;
+    }
+
+private:
+    uint32_t _irq;
+};
@@ -0,0 +1,5 @@
+// Host stub of the ESP-IDF high resolution timer.
+#pragma once
+#include "Arduino.h"
+
+inline int64_t esp_timer_get_time() { return (int64_t) hostMicros(); }
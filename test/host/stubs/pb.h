@@ -0,0 +1,33 @@
+// Host stub of nanopb's pb.h: the types used by the generated structs.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint_least16_t pb_size_t;
+typedef uint8_t pb_byte_t;
+
+#define PB_BYTES_ARRAY_T(n) struct { pb_size_t size; pb_byte_t bytes[n]; }
+
+typedef struct pb_callback_s {
+  void *funcs;
+  void *arg;
+} pb_callback_t;
+
+typedef struct pb_msgdesc_s {
+  int unused;
+} pb_msgdesc_t;
+
+typedef struct pb_ostream_s {
+  pb_byte_t *buf;
+  size_t max_size;
+  size_t bytes_written;
+  const char *errmsg;
+} pb_ostream_t;
+
+typedef struct pb_istream_s {
+  const pb_byte_t *buf;
+  size_t bytes_left;
+  const char *errmsg;
+} pb_istream_t;
+
+#define PB_GET_ERROR(stream) ((stream)->errmsg ? (stream)->errmsg : "(none)")
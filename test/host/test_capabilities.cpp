@@ -0,0 +1,38 @@
+// Capabilities descriptor: record layout and hash.
+
+#include "check.h"
+#include "modules/RFQCapabilities.h"
+
+int main() {
+  RFQCapabilities capabilities;
+  CHECK(capabilities.isEmpty())
+
+  CHECK(capabilities.add("radioA", "bitRate", "FloatValue", "Bit rate (kbps)", 1))
+  CHECK(capabilities.add("ping", "ping", "VoidValue", "", 2))
+  capabilities.finish();
+
+  // <module>\0<command>\0<argumentType>\0<description>\0<cmdType byte>
+  static const char expected[] = "radioA\0bitRate\0FloatValue\0Bit rate (kbps)\0\x01"
+                                 "ping\0ping\0VoidValue\0\0\x02";
+  CHECK_EQ(capabilities.getSize(), sizeof(expected) - 1)
+  CHECK(memcmp(capabilities.getData(), expected, sizeof(expected) - 1) == 0)
+
+  // FNV-1a of the records.
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < sizeof(expected) - 1; i++) hash = (hash ^ (uint8_t) expected[i]) * 16777619u;
+  CHECK_EQ(capabilities.getHash(), hash)
+
+  // Grows past its first allocation.
+  char description[200];
+  memset(description, 'x', sizeof(description) - 1);
+  description[sizeof(description) - 1] = 0;
+  for (uint8_t i = 0; i < 20; i++) CHECK(capabilities.add("module", "command", "UintValue", description, 1))
+  capabilities.finish();
+  CHECK_EQ(capabilities.getSize(), sizeof(expected) - 1 + 20 * (7 + 8 + 10 + 200 + 1))
+  CHECK(capabilities.getHash() != hash)
+
+  capabilities.clear();
+  CHECK(capabilities.isEmpty())
+  CHECK_EQ(capabilities.getHash(), 0)
+  return CHECK_RESULT();
+}
@@ -0,0 +1,67 @@
+// Command routing table: lookup by hashes, confirmed by name, typed and untyped commands.
+
+#include "check.h"
+#include "modules/RFQModule.h"
+
+/**
+ * Records which handler ran.
+ */
+struct Recorder {
+    const char *ran = nullptr;
+    uint8_t argsLen = 0;
+};
+
+static RFQCommandRoutes routes;
+static Recorder recorder;
+
+// Typed routes, as CMD_MATCHES_SET adds them, or untyped (nullptr type), as CMD_MATCHES_GET does.
+#define ROUTE(verb, type, name, label) \
+  routes.add(verb, rfquack_hash(verb), type, name, rfquack_hash(name), \
+             [r](char *, char **, uint8_t argsLen, char *, unsigned int) { r->ran = label; r->argsLen = argsLen; })
+
+static bool dispatch(const char *verb, const char *arg0, const char *arg1, uint8_t argsLen) {
+  char *args[] = {(char *) arg0, (char *) arg1};
+  recorder.ran = nullptr;
+  return routes.dispatch(rfquack_hash(verb), arg0 != nullptr ? rfquack_hash(arg0) : 0,
+                         arg1 != nullptr ? rfquack_hash(arg1) : 0, (char *) verb, args, argsLen, nullptr, 0);
+}
+
+int main() {
+  Recorder *r = &recorder;
+
+  // Added in any order, sorted once.
+  CHECK(ROUTE("set", "rfquack_FloatValue", "frequency", "set frequency"))
+  CHECK(ROUTE("get", nullptr, "frequency", "get frequency"))
+  CHECK(ROUTE("set", "rfquack_VoidValue", "rx", "set rx"))
+  CHECK(ROUTE("set", "rfquack_FloatValue", "bitRate", "set bitRate"))
+  routes.finish();
+  CHECK_EQ(routes.getCount(), 4)
+
+  // Set commands: type, then name.
+  CHECK(dispatch("set", "rfquack_FloatValue", "frequency", 2))
+  CHECK(strcmp(recorder.ran, "set frequency") == 0)
+  CHECK_EQ(recorder.argsLen, 2)
+  CHECK(dispatch("set", "rfquack_VoidValue", "rx", 2))
+  CHECK(strcmp(recorder.ran, "set rx") == 0)
+
+  // The type must match too.
+  CHECK(!dispatch("set", "rfquack_VoidValue", "frequency", 2))
+  CHECK(recorder.ran == nullptr)
+
+  // Get commands: name first, whatever follows it.
+  CHECK(dispatch("get", "frequency", nullptr, 1))
+  CHECK(strcmp(recorder.ran, "get frequency") == 0)
+  CHECK(dispatch("get", "frequency", "rfquack_FloatValue", 2))
+  CHECK(strcmp(recorder.ran, "get frequency") == 0)
+
+  // Unknown verbs and names, and missing arguments, match nothing.
+  CHECK(!dispatch("unset", "rfquack_FloatValue", "frequency", 2))
+  CHECK(!dispatch("get", "bitRate", nullptr, 1))
+  CHECK(!dispatch("set", "rfquack_FloatValue", nullptr, 1))
+  CHECK(!dispatch("get", nullptr, nullptr, 0))
+
+  routes.clear();
+  CHECK_EQ(routes.getCount(), 0)
+  CHECK(!dispatch("get", "frequency", nullptr, 1))
+  return CHECK_RESULT();
+}
@@ -0,0 +1,235 @@
+// Packet pool, RX ring and TX queue: ownership of pool slots as packets go through them.
+
+#include "check.h"
+#include "radio/RadioLibWrapper.h"
+
+static RFQPacketPool pool;
+
+static void checkPoolReferences() {
+  CHECK_EQ(pool.available(), RFQUACK_PACKET_POOL_SIZE)
+
+  rfquack_packet_handle_t a = pool.acquire();
+  rfquack_packet_handle_t b = pool.acquire();
+  CHECK(a != RFQUACK_PACKET_HANDLE_NONE && b != RFQUACK_PACKET_HANDLE_NONE && a != b)
+  CHECK_EQ(pool.available(), RFQUACK_PACKET_POOL_SIZE - 2)
+  CHECK_EQ(pool.handleOf(pool.get(a)), a)
+
+  rfquack_Packet outside;
+  CHECK_EQ(pool.handleOf(&outside), RFQUACK_PACKET_HANDLE_NONE)
+  CHECK(pool.get(RFQUACK_PACKET_HANDLE_NONE) == nullptr)
+
+  // A retained slot stays taken until every owner releases it.
+  pool.retain(a);
+  pool.release(a);
+  CHECK_EQ(pool.available(), RFQUACK_PACKET_POOL_SIZE - 2)
+  pool.release(a);
+  pool.release(b);
+  CHECK_EQ(pool.available(), RFQUACK_PACKET_POOL_SIZE)
+
+  // Releasing a free slot again doesn't make room twice.
+  pool.release(a);
+  CHECK_EQ(pool.available(), RFQUACK_PACKET_POOL_SIZE)
+
+  // Reused slots come back zeroed.
+  pool.get(pool.acquire())->data.size = 42;
+  for (uint8_t i = 0; i < RFQUACK_PACKET_POOL_SIZE; i++) pool.release(i);
+  for (uint8_t i = 0; i < RFQUACK_PACKET_POOL_SIZE; i++) CHECK_EQ(pool.get(pool.acquire())->data.size, 0)
+  for (uint8_t i = 0; i < RFQUACK_PACKET_POOL_SIZE; i++) pool.release(i);
+}
+
+static void checkPoolReservations() {
+  pool.reserve(rfquack_WhichRadio_RadioA);
+  pool.reserve(rfquack_WhichRadio_RadioB);
+
+  // A chatty radio gets everything but the slots reserved for the other one.
+  uint8_t taken = 0;
+  while (pool.acquire(rfquack_WhichRadio_RadioA) != RFQUACK_PACKET_HANDLE_NONE) taken++;
+  CHECK_EQ(taken, RFQUACK_PACKET_POOL_SIZE - RFQUACK_PACKET_POOL_RESERVED_PER_RADIO)
+  CHECK_EQ(pool.held(rfquack_WhichRadio_RadioA), taken)
+
+  // Shared owners can't take them either.
+  CHECK_EQ(pool.acquire(), RFQUACK_PACKET_HANDLE_NONE)
+
+  // The quiet radio still receives.
+  for (uint8_t i = 0; i < RFQUACK_PACKET_POOL_RESERVED_PER_RADIO; i++) {
+    CHECK(pool.acquire(rfquack_WhichRadio_RadioB) != RFQUACK_PACKET_HANDLE_NONE)
+  }
+  CHECK_EQ(pool.acquire(rfquack_WhichRadio_RadioB), RFQUACK_PACKET_HANDLE_NONE)
+  CHECK_EQ(pool.available(), 0)
+
+  for (uint8_t i = 0; i < RFQUACK_PACKET_POOL_SIZE; i++) pool.release(i);
+  CHECK_EQ(pool.held(rfquack_WhichRadio_RadioA), 0)
+  CHECK_EQ(pool.held(rfquack_WhichRadio_RadioB), 0)
+  CHECK_EQ(pool.available(), RFQUACK_PACKET_POOL_SIZE)
+}
+
+static void checkRing() {
+  static RFQPacketRing ring;
+  rfquack_packet_handle_t handle;
+  CHECK(!ring.pop(&handle))
+
+  for (uint32_t i = 0; i < RFQUACK_RADIO_RX_QUEUE_LEN; i++) {
+    handle = (rfquack_packet_handle_t) (i % RFQUACK_PACKET_POOL_SIZE);
+    CHECK(ring.push(&handle))
+  }
+  CHECK(ring.isFull())
+  CHECK_EQ(ring.getHighWater(), RFQUACK_RADIO_RX_QUEUE_LEN)
+
+  // Full: the new handle is refused, and the drop accounted.
+  handle = 0xAA;
+  CHECK(!ring.push(&handle))
+  CHECK_EQ(ring.getDrops(), 1)
+
+  // Or the oldest one makes room for it.
+  rfquack_packet_handle_t evicted;
+  ring.pushEvictingOldest(&handle, &evicted);
+  CHECK_EQ(evicted, 0)
+  CHECK_EQ(ring.getDrops(), 2)
+  CHECK_EQ(ring.getCount(), RFQUACK_RADIO_RX_QUEUE_LEN)
+
+  // Handles come out in order, the evicting one last.
+  for (uint32_t i = 1; i < RFQUACK_RADIO_RX_QUEUE_LEN; i++) {
+    CHECK(ring.pop(&handle))
+    CHECK_EQ(handle, i % RFQUACK_PACKET_POOL_SIZE)
+  }
+  CHECK(ring.pop(&handle))
+  CHECK_EQ(handle, 0xAA)
+  CHECK_EQ(ring.getCount(), 0)
+
+  // With room left nothing is evicted.
+  ring.pushEvictingOldest(&handle, &evicted);
+  CHECK_EQ(evicted, RFQUACK_PACKET_HANDLE_NONE)
+  CHECK(ring.pop(&handle))
+}
+
+// Fills the ring with packets from the global pool.
+static void fillRxQueue(RFQPacketRing *ring) {
+  while (!ring->isFull()) {
+    rfquack_packet_handle_t handle = packetPool.acquire();
+    ring->push(&handle);
+  }
+}
+
+static void drainRxQueue(RFQPacketRing *ring) {
+  rfquack_packet_handle_t handle;
+  while (ring->pop(&handle)) packetPool.release(handle);
+}
+
+static void checkRxOverflowPolicies() {
+  static RFQPacketRing ring;
+  RFQRadioStats stats;
+  RFQRxOverflow overflow;
+  uint8_t available = packetPool.available();
+
+  // Drop newest: the packet is given back to the pool.
+  overflow.policy = rfquack_RxOverflowPolicy_DROP_NEWEST;
+  fillRxQueue(&ring);
+  rfquack_packet_handle_t oldest;
+  rfquack_packet_handle_t newest = packetPool.acquire();
+  CHECK(!enqueueRxPacket(newest, &ring, overflow, stats))
+  CHECK_EQ(stats.dropped, 1)
+  CHECK_EQ(packetPool.available(), available - RFQUACK_RADIO_RX_QUEUE_LEN)
+  drainRxQueue(&ring);
+
+  // Drop oldest: the evicted packet is given back, the new one is queued last.
+  overflow.policy = rfquack_RxOverflowPolicy_DROP_OLDEST;
+  fillRxQueue(&ring);
+  newest = packetPool.acquire();
+  CHECK(!enqueueRxPacket(newest, &ring, overflow, stats))
+  CHECK_EQ(stats.dropped, 2)
+  CHECK_EQ(packetPool.available(), available - RFQUACK_RADIO_RX_QUEUE_LEN)
+  for (uint32_t i = 0; i < RFQUACK_RADIO_RX_QUEUE_LEN; i++) ring.pop(&oldest);
+  CHECK_EQ(oldest, newest)
+  packetPool.release(oldest);
+  for (uint8_t i = 0; i < RFQUACK_PACKET_POOL_SIZE; i++) packetPool.release(i);
+
+  // Sample: one packet every sampleEvery evicts the oldest one.
+  overflow.policy = rfquack_RxOverflowPolicy_SAMPLE;
+  overflow.sampleEvery = 4;
+  fillRxQueue(&ring);
+  rfquack_packet_handle_t overflowing[8];
+  for (uint8_t i = 0; i < 8; i++) {
+    overflowing[i] = packetPool.acquire();
+    CHECK(!enqueueRxPacket(overflowing[i], &ring, overflow, stats))
+  }
+  CHECK_EQ(stats.dropped, 10)
+  CHECK_EQ(overflow.overflowed, 8)
+  CHECK_EQ(packetPool.available(), available - RFQUACK_RADIO_RX_QUEUE_LEN)
+  for (uint32_t i = 0; i < RFQUACK_RADIO_RX_QUEUE_LEN - 2; i++) ring.pop(&oldest);
+  ring.pop(&oldest);
+  CHECK_EQ(oldest, overflowing[3])
+  ring.pop(&oldest);
+  CHECK_EQ(oldest, overflowing[7])
+  for (uint8_t i = 0; i < RFQUACK_PACKET_POOL_SIZE; i++) packetPool.release(i);
+  CHECK_EQ(packetPool.available(), available)
+}
+
+static void checkTxQueue() {
+  RFQTxQueue queue;
+  uint8_t available = packetPool.available();
+  uint32_t jobId = 0;
+
+  // Packets from outside the pool are copied into it.
+  rfquack_Packet pkt = rfquack_Packet_init_zero;
+  pkt.data.size = 3;
+  pkt.has_repeat = true;
+  pkt.repeat = 2;
+  CHECK_EQ(queue.enqueue(&pkt, &jobId), RADIOLIB_ERR_NONE)
+  CHECK_EQ(jobId, 1)
+  CHECK_EQ(packetPool.available(), available - 1)
+  CHECK_EQ(queue.packetOf(queue.front())->data.size, 3)
+  CHECK_EQ(queue.front()->remaining, 2)
+
+  // Packets already in the pool are retained, not copied.
+  rfquack_packet_handle_t handle = packetPool.acquire();
+  CHECK_EQ(queue.enqueue(packetPool.get(handle), &jobId), RADIOLIB_ERR_NONE)
+  CHECK_EQ(jobId, 2)
+  packetPool.release(handle);
+  CHECK_EQ(packetPool.available(), available - 2)
+
+  // A relative delay counts from the previous frame due time.
+  pkt = rfquack_Packet_init_zero;
+  pkt.has_txAtUs = true;
+  pkt.txAtUs = 1000000000;
+  pkt.has_repeat = true;
+  pkt.repeat = 3;
+  pkt.has_repeatGapUs = true;
+  pkt.repeatGapUs = 100;
+  CHECK_EQ(queue.enqueue(&pkt, &jobId), RADIOLIB_ERR_NONE)
+  pkt = rfquack_Packet_init_zero;
+  pkt.has_txDelayUs = true;
+  pkt.txDelayUs = 50;
+  CHECK_EQ(queue.enqueue(&pkt, &jobId), RADIOLIB_ERR_NONE)
+
+  while (queue.enqueue(&pkt, &jobId) == RADIOLIB_ERR_NONE) {}
+  CHECK_EQ(queue.enqueue(&pkt, &jobId), ERR_TX_QUEUE_FULL)
+
+  // Jobs complete in order, each one leaving a report.
+  rfquack_TxReport report = rfquack_TxReport_init_zero;
+  uint32_t completed = 0;
+  while (RFQTxJob *job = queue.front()) {
+    if (job->id == 3) {
+      CHECK_EQ(job->dueUs, 1000000000)
+      RFQTxQueue::advance(job, 0);
+      CHECK_EQ(job->dueUs, 1000000100)
+    }
+    if (job->id == 4) CHECK_EQ(job->dueUs, 1000000000 + 200 + 50)
+    job->sent = 1;
+    queue.complete();
+    CHECK(queue.popReport(&report))
+    CHECK_EQ(report.jobId, ++completed)
+    CHECK_EQ(report.sent, 1)
+  }
+  CHECK_EQ(completed, RFQUACK_RADIO_TX_QUEUE_LEN)
+  CHECK(!queue.popReport(&report))
+  CHECK_EQ(packetPool.available(), available)
+}
+
+int main() {
+  checkPoolReferences();
+  checkPoolReservations();
+  checkRing();
+  checkRxOverflowPolicies();
+  checkTxQueue();
+  return CHECK_RESULT();
+}
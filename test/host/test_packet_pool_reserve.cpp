@@ -0,0 +1,29 @@
+// Packet pool reservations with more radios than the pool can serve: 20 slots, 8 reserved per radio.
+
+#include "check.h"
+#include "radio/RFQPacketPool.h"
+
+static RFQPacketPool pool;
+
+int main() {
+  // The third radio only gets what's left, one slot stays shared.
+  CHECK_EQ(pool.reserve(rfquack_WhichRadio_RadioA), 8)
+  CHECK_EQ(pool.reserve(rfquack_WhichRadio_RadioB), 8)
+  CHECK_EQ(pool.reserve(rfquack_WhichRadio_RadioC), 3)
+  CHECK_EQ(pool.reserve(rfquack_WhichRadio_RadioD), 0)
+
+  // Reserving again doesn't count a radio's own reservation against it.
+  CHECK_EQ(pool.reserve(rfquack_WhichRadio_RadioA), 8)
+
+  rfquack_packet_handle_t shared = pool.acquire();
+  CHECK(shared != RFQUACK_PACKET_HANDLE_NONE)
+  CHECK_EQ(pool.acquire(), RFQUACK_PACKET_HANDLE_NONE)
+  pool.release(shared);
+
+  // Each radio still gets its reservation.
+  for (uint8_t i = 0; i < 8; i++) CHECK(pool.acquire(rfquack_WhichRadio_RadioA) != RFQUACK_PACKET_HANDLE_NONE)
+  for (uint8_t i = 0; i < 8; i++) CHECK(pool.acquire(rfquack_WhichRadio_RadioB) != RFQUACK_PACKET_HANDLE_NONE)
+  for (uint8_t i = 0; i < 3; i++) CHECK(pool.acquire(rfquack_WhichRadio_RadioC) != RFQUACK_PACKET_HANDLE_NONE)
+  CHECK_EQ(pool.available(), 1)
+  return CHECK_RESULT();
+}
@@ -0,0 +1,229 @@
+// Register cache, register image and register programs.
+
+#include "check.h"
+#include "radio/RFQRegisterProgram.h"
+
+static void checkRegisterCache() {
+  RFQRegisterCache cache;
+  uint8_t value;
+  CHECK(!cache.get(0x10, &value))
+
+  cache.set(0x10, 0x5A);
+  CHECK(cache.get(0x10, &value))
+  CHECK_EQ(value, 0x5A)
+
+  // Addresses out of the cache are never known.
+  cache.set(RFQRegisterCache::SIZE, 1);
+  CHECK(!cache.get(RFQRegisterCache::SIZE, &value))
+
+  cache.invalidate();
+  CHECK(!cache.get(0x10, &value))
+
+  // Masked writes to an address merge into one pending write.
+  CHECK(!cache.stage(0x12, 0x03, 0x0F))
+  CHECK(!cache.stage(0x10, 0x80, 0x80))
+  CHECK(cache.stage(0x12, 0x50, 0xF0))
+  CHECK(cache.stage(0x12, 0x01, 0x01))
+  CHECK_EQ(cache.getPendingCount(), 2)
+  CHECK_EQ(cache.getPendingValue(0x12), 0x53)
+  CHECK_EQ(cache.getPendingMask(0x12), 0xFF)
+  CHECK(cache.isPending(0x10))
+  CHECK(!cache.isPending(0x11))
+
+  // Flushed in the order addresses were first written.
+  CHECK_EQ(cache.getPending(0), 0x12)
+  CHECK_EQ(cache.getPending(1), 0x10)
+  CHECK(!cache.stage(0x11, 0x01, 0x01))
+  cache.clearPending(0x12);
+  CHECK_EQ(cache.getPendingCount(), 2)
+  CHECK_EQ(cache.getPending(0), 0x10)
+  CHECK_EQ(cache.getPending(1), 0x11)
+  CHECK(!cache.isPending(0x12))
+
+  // A cleared address starts a new pending write, at the end.
+  CHECK(!cache.stage(0x12, 0x02, 0x02))
+  CHECK_EQ(cache.getPendingValue(0x12), 0x02)
+  CHECK_EQ(cache.getPending(2), 0x12)
+
+  // Pending writes survive invalidate().
+  cache.invalidate();
+  CHECK_EQ(cache.getPendingCount(), 3)
+}
+
+static void checkRegisterImage() {
+  RFQRegisterImage<0x10, 8> image;
+  memset(image.data(), 0x11, RFQRegisterImage<0x10, 8>::LENGTH);
+
+  // Writing the current value changes nothing.
+  image.set(0x13, 0x11);
+  CHECK_EQ(image.getDirtyLength(), 0)
+
+  // Only the bits in msb..lsb are written.
+  image.set(0x13, 0xF0, 5, 4);
+  CHECK_EQ(image.get(0x13), 0x31)
+  CHECK_EQ(image.getDirtyFirst(), 0x13)
+  CHECK_EQ(image.getDirtyLength(), 1)
+
+  // The dirty range grows both ways to cover every change.
+  image.set(0x15, 0x00);
+  CHECK_EQ(image.getDirtyFirst(), 0x13)
+  CHECK_EQ(image.getDirtyLength(), 3)
+  image.set(0x11, 0xFF);
+  CHECK_EQ(image.getDirtyFirst(), 0x11)
+  CHECK_EQ(image.getDirtyLength(), 5)
+  CHECK(image.getDirty() == image.data() + 1)
+  image.set(0x14, 0x22);
+  CHECK_EQ(image.getDirtyLength(), 5)
+}
+
+/**
+ * Radio bridge recording what a program does, registers start at 0.
+ */
+class RecordingRadio {
+public:
+    uint8_t registers[256] = {0};
+    uint32_t writes = 0;
+    uint32_t flushes = 0;
+    rfquack_Mode mode = rfquack_Mode_IDLE;
+
+    void writeRegister(rfquack_register_address_t reg, rfquack_register_value_t value, rfquack_WhichRadio) {
+      registers[reg] = value;
+      writes++;
+    }
+
+    void writeRegister(rfquack_register_address_t reg, rfquack_register_value_t value, uint8_t msb, uint8_t lsb,
+                       rfquack_WhichRadio) {
+      uint8_t mask = (uint8_t) ((0xFF << lsb) & (0xFF >> (7 - msb)));
+      registers[reg] = (registers[reg] & ~mask) | (value & mask);
+      writes++;
+    }
+
+    rfquack_register_value_t readRegister(rfquack_register_address_t reg, rfquack_WhichRadio) {
+      return registers[reg];
+    }
+
+    void flushRegisters(rfquack_WhichRadio) {
+      flushes++;
+    }
+
+    int16_t setMode(rfquack_Mode newMode, rfquack_WhichRadio) {
+      mode = newMode;
+      return RADIOLIB_ERR_NONE;
+    }
+
+    int16_t getRSSI(float *rssi, rfquack_WhichRadio) {
+      *rssi = -200;
+      return RADIOLIB_ERR_NONE;
+    }
+};
+
+#define VALIDATE(...) { \
+  const uint8_t program[] = {__VA_ARGS__}; \
+  validation = RFQRegisterProgram::validate(program, sizeof(program)); \
+}
+
+static void checkProgramValidation() {
+  int16_t validation;
+  CHECK_EQ(RFQRegisterProgram::validate(nullptr, 0), RADIOLIB_ERR_NONE)
+
+  VALIDATE(RFQRegisterProgram::OP_WRITE, 0x10, 0x01, RFQRegisterProgram::OP_RSSI)
+  CHECK_EQ(validation, RADIOLIB_ERR_NONE)
+
+  // Operands past the end of the program.
+  VALIDATE(RFQRegisterProgram::OP_WRITE, 0x10)
+  CHECK_EQ(validation, ERR_INVALID_PROGRAM)
+  VALIDATE(RFQRegisterProgram::OP_DELAY, 0x10)
+  CHECK_EQ(validation, ERR_INVALID_PROGRAM)
+
+  // Unknown opcode.
+  VALIDATE(0x00)
+  CHECK_EQ(validation, ERR_INVALID_PROGRAM)
+  VALIDATE(RFQRegisterProgram::OP_NEXT + 1)
+  CHECK_EQ(validation, ERR_INVALID_PROGRAM)
+
+  // UPDATE bits: msb up to 7, lsb up to msb.
+  VALIDATE(RFQRegisterProgram::OP_UPDATE, 0x10, 0x74, 0x00)
+  CHECK_EQ(validation, RADIOLIB_ERR_NONE)
+  VALIDATE(RFQRegisterProgram::OP_UPDATE, 0x10, 0x80, 0x00)
+  CHECK_EQ(validation, ERR_INVALID_PROGRAM)
+  VALIDATE(RFQRegisterProgram::OP_UPDATE, 0x10, 0x34, 0x00)
+  CHECK_EQ(validation, ERR_INVALID_PROGRAM)
+
+  VALIDATE(RFQRegisterProgram::OP_MODE, rfquack_Mode_JAM)
+  CHECK_EQ(validation, RADIOLIB_ERR_NONE)
+  VALIDATE(RFQRegisterProgram::OP_MODE, rfquack_Mode_JAM + 1)
+  CHECK_EQ(validation, ERR_INVALID_PROGRAM)
+
+  // REPEAT / NEXT nesting.
+  VALIDATE(RFQRegisterProgram::OP_REPEAT, 0)
+  CHECK_EQ(validation, ERR_INVALID_PROGRAM)
+  VALIDATE(RFQRegisterProgram::OP_REPEAT, 2)
+  CHECK_EQ(validation, ERR_INVALID_PROGRAM)
+  VALIDATE(RFQRegisterProgram::OP_NEXT)
+  CHECK_EQ(validation, ERR_INVALID_PROGRAM)
+  VALIDATE(RFQRegisterProgram::OP_REPEAT, 2, RFQRegisterProgram::OP_REPEAT, 2, RFQRegisterProgram::OP_REPEAT, 2,
+           RFQRegisterProgram::OP_REPEAT, 2, RFQRegisterProgram::OP_NEXT, RFQRegisterProgram::OP_NEXT,
+           RFQRegisterProgram::OP_NEXT, RFQRegisterProgram::OP_NEXT)
+  CHECK_EQ(validation, RADIOLIB_ERR_NONE)
+  VALIDATE(RFQRegisterProgram::OP_REPEAT, 2, RFQRegisterProgram::OP_REPEAT, 2, RFQRegisterProgram::OP_REPEAT, 2,
+           RFQRegisterProgram::OP_REPEAT, 2, RFQRegisterProgram::OP_REPEAT, 2, RFQRegisterProgram::OP_NEXT,
+           RFQRegisterProgram::OP_NEXT, RFQRegisterProgram::OP_NEXT, RFQRegisterProgram::OP_NEXT,
+           RFQRegisterProgram::OP_NEXT)
+  CHECK_EQ(validation, ERR_INVALID_PROGRAM)
+}
+
+static void checkProgramRun() {
+  RecordingRadio radio;
+  uint8_t results[8];
+  size_t resultsLen;
+
+  // Sweep a register, reading it back and sampling the RSSI at each step.
+  const uint8_t sweep[] = {
+    RFQRegisterProgram::OP_WRITE, 0x1B, 0x40,
+    RFQRegisterProgram::OP_MODE, rfquack_Mode_RX,
+    RFQRegisterProgram::OP_REPEAT, 3,
+    RFQRegisterProgram::OP_ADD, 0x1B, 0x01,
+    RFQRegisterProgram::OP_READ, 0x1B,
+    RFQRegisterProgram::OP_RSSI,
+    RFQRegisterProgram::OP_NEXT,
+    RFQRegisterProgram::OP_UPDATE, 0x1B, 0x10, 0xFF
+  };
+  CHECK_EQ(RFQRegisterProgram::run(&radio, rfquack_WhichRadio_RadioA, sweep, sizeof(sweep), results,
+                                   sizeof(results), &resultsLen), RADIOLIB_ERR_NONE)
+  CHECK_EQ(resultsLen, 6)
+  CHECK_EQ(results[0], 0x41)
+  CHECK_EQ(results[2], 0x42)
+  CHECK_EQ(results[4], 0x43)
+  CHECK_EQ((int8_t) results[1], -128)
+  CHECK_EQ(radio.registers[0x1B], 0x43)
+  CHECK_EQ(radio.mode, rfquack_Mode_RX)
+
+  // Results past the buffer stop the program, keeping what fit.
+  CHECK_EQ(RFQRegisterProgram::run(&radio, rfquack_WhichRadio_RadioA, sweep, sizeof(sweep), results, 3,
+                                   &resultsLen), ERR_PROGRAM_TOO_LONG)
+  CHECK_EQ(resultsLen, 3)
+  CHECK_EQ(radio.registers[0x1B], 0x42)
+
+  // A malformed program doesn't touch the radio, even where its start is valid.
+  const uint8_t broken[] = {
+    RFQRegisterProgram::OP_WRITE, 0x1B, 0x00,
+    RFQRegisterProgram::OP_REPEAT, 2,
+    RFQRegisterProgram::OP_READ, 0x1B
+  };
+  uint32_t writes = radio.writes;
+  uint32_t flushes = radio.flushes;
+  CHECK_EQ(RFQRegisterProgram::run(&radio, rfquack_WhichRadio_RadioA, broken, sizeof(broken), results,
+                                   sizeof(results), &resultsLen), ERR_INVALID_PROGRAM)
+  CHECK_EQ(resultsLen, 0)
+  CHECK_EQ(radio.writes, writes)
+  CHECK_EQ(radio.flushes, flushes)
+  CHECK_EQ(radio.registers[0x1B], 0x42)
+}
+
+int main() {
+  checkRegisterCache();
+  checkRegisterImage();
+  checkProgramValidation();
+  checkProgramRun();
+  return CHECK_RESULT();
+}